@@ -0,0 +1,676 @@
+/**
+ * @file StringUtilsBenchmarks.cpp
+ *
+ * This module contains benchmarks of the StringUtils functions.
+ *
+ * Each benchmark is run over inputs from 16 bytes to 64 MB, taken from
+ * synthetic corpora in which the density of delimiters (or whatever
+ * else the function looks for) and of escaped characters is controlled
+ * by the benchmark arguments, given in characters per thousand.
+ * Throughput is reported in bytes per second, along with the number of
+ * memory allocations made per call.
+ *
+ * Run with "--benchmark_format=json" or "--benchmark_out=<file>" to
+ * save results in a form which can be compared between runs.
+ *
+ * © 2024 by Hatem Nabli
+ */
+
+#include <benchmark\benchmark.h>
+#include <StringUtils\Instrumentation.hpp>
+#include <StringUtils\MappedFile.hpp>
+#include <StringUtils\StringUtils.hpp>
+#include <atomic>
+#include <map>
+#include <new>
+#include <random>
+#include <set>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#if defined(_WIN32)
+#    include <malloc.h>
+#endif
+
+namespace
+{
+    /**
+     * This is the number of memory allocations made so far
+     * through the global operator new.
+     */
+    std::atomic<size_t> allocations(0);
+
+    /**
+     * These are the input sizes over which each benchmark is run.
+     */
+    const auto sizes = benchmark::CreateRange(16, 64 << 20, 16);
+
+    /**
+     * These are the densities, in characters per thousand, of the
+     * delimiters or other special characters in the inputs.
+     */
+    const std::vector<int64_t> densities = {10, 100, 250};
+
+    /**
+     * These are the densities, in characters per thousand, of the
+     * escaped characters in the inputs.
+     */
+    const std::vector<int64_t> escapeDensities = {0, 20};
+
+    /**
+     * This describes how to generate a corpus.
+     */
+    struct CorpusKey
+    {
+        /**
+         * This is the number of characters in the corpus.
+         */
+        size_t size;
+
+        /**
+         * This is how many characters per thousand are taken from
+         * the special characters rather than being letters.
+         */
+        int64_t density;
+
+        /**
+         * This is how many characters per thousand are escaped.
+         */
+        int64_t escapeDensity;
+
+        /**
+         * These are the special characters.
+         */
+        std::string specials;
+
+        bool operator<(const CorpusKey& other) const {
+            return (std::tie(size, density, escapeDensity, specials)
+                    < std::tie(other.size, other.density, other.escapeDensity, other.specials));
+        }
+    };
+
+    /**
+     * This function returns a corpus of the given size, consisting of
+     * random upper- and lower-case letters, with the given densities of
+     * special characters and of characters escaped with a backslash.
+     * The same pseudo-random sequence is used every time, so that every
+     * run measures the same input, and the last corpus generated is kept
+     * for the next benchmark which asks for the same one.
+     *
+     * @param[in] size
+     *      This is the number of characters in the corpus.
+     *
+     * @param[in] density
+     *      This is how many characters per thousand are taken from
+     *      the special characters rather than being letters.
+     *
+     * @param[in] escapeDensity
+     *      This is how many characters per thousand are escaped.
+     *
+     * @param[in] specials
+     *      These are the special characters.
+     *
+     * @return
+     *      The corpus is returned.
+     */
+    const std::string& GetCorpus(size_t size, int64_t density, int64_t escapeDensity,
+                                 const std::string& specials) {
+        static CorpusKey lastKey;
+        static std::string corpus;
+        const CorpusKey key{size, density, escapeDensity, specials};
+        if (!(key < lastKey) && !(lastKey < key) && (corpus.length() == size))
+        { return corpus; }
+        lastKey = key;
+        corpus.clear();
+        std::mt19937 generator(0x5eed);
+        std::uniform_int_distribution<int> perMille(0, 999);
+        std::uniform_int_distribution<int> letter(0, 51);
+        std::uniform_int_distribution<size_t> special(0, specials.length() - 1);
+        corpus.reserve(size);
+        while (corpus.length() < size)
+        {
+            if ((perMille(generator) < escapeDensity) && (corpus.length() + 2 <= size))
+            { corpus += '\\'; }
+            if (perMille(generator) < density)
+            {
+                corpus += specials[special(generator)];
+            } else
+            {
+                const auto n = letter(generator);
+                corpus += (char)((n < 26) ? ('a' + n) : ('A' + n - 26));
+            }
+        }
+        return corpus;
+    }
+
+    /**
+     * This function records the bytes processed and the memory
+     * allocations made per call by a finished benchmark.
+     *
+     * @param[in, out] state
+     *      This is the state of the benchmark.
+     *
+     * @param[in] bytesPerCall
+     *      This is the number of bytes of input processed by each call.
+     *
+     * @param[in] allocationsBefore
+     *      This is the number of allocations made before the benchmark
+     *      loop began.
+     */
+    void Report(benchmark::State& state, size_t bytesPerCall, size_t allocationsBefore) {
+        state.SetBytesProcessed((int64_t)(bytesPerCall * state.iterations()));
+        state.counters["allocs/call"] = benchmark::Counter(
+            (double)(allocations.load(std::memory_order_relaxed) - allocationsBefore),
+            benchmark::Counter::kAvgIterations
+        );
+    }
+
+    /**
+     * This function returns the number of allocations made so far.
+     */
+    size_t Allocations() {
+        return allocations.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * This function counts an allocation.
+     */
+    void CountAllocation() {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        StringUtils::Instrumentation::CountAllocation();
+    }
+
+    /**
+     * This function counts and makes an allocation for the replaced
+     * global operator new.
+     *
+     * @param[in] size
+     *      This is the number of bytes requested.
+     *
+     * @return
+     *      The allocated memory is returned, or nullptr if there
+     *      isn't enough memory.
+     */
+    void* Allocate(size_t size) noexcept {
+        CountAllocation();
+        return malloc((size == 0) ? 1 : size);
+    }
+
+    /**
+     * This function counts and makes an allocation with the given
+     * alignment for the replaced global operator new.
+     *
+     * @param[in] size
+     *      This is the number of bytes requested.
+     *
+     * @param[in] alignment
+     *      This is the alignment required.
+     *
+     * @return
+     *      The allocated memory is returned, or nullptr if there
+     *      isn't enough memory.
+     */
+    void* AllocateAligned(size_t size, std::align_val_t alignment) noexcept {
+        CountAllocation();
+        const auto bytes = (size_t)alignment;
+#if defined(_WIN32)
+        return _aligned_malloc((size == 0) ? 1 : size, bytes);
+#else
+        // aligned_alloc requires the size to be a multiple of the alignment.
+        return aligned_alloc(bytes, ((size + bytes - 1) / bytes + (size == 0)) * bytes);
+#endif
+    }
+
+    /**
+     * This function frees memory allocated by AllocateAligned.
+     *
+     * @param[in] p
+     *      This is the memory to free.
+     */
+    void FreeAligned(void* p) noexcept {
+#if defined(_WIN32)
+        _aligned_free(p);
+#else
+        free(p);
+#endif
+    }
+
+    /**
+     * This function calls the handler installed for when memory
+     * runs out, for the replaced global operator new, which then
+     * tries the allocation again.
+     *
+     * @throw std::bad_alloc
+     *      This is thrown if no handler is installed.
+     */
+    void HandleOutOfMemory() {
+        const auto handler = std::get_new_handler();
+        if (handler == nullptr)
+        { throw std::bad_alloc(); }
+        handler();
+    }
+}
+
+// Every form of the global operators new and delete is replaced, so that
+// all allocations are counted, and all memory is freed the way it was
+// allocated.
+
+void* operator new(size_t size) {
+    auto p = Allocate(size);
+    while (p == nullptr)
+    {
+        HandleOutOfMemory();
+        p = Allocate(size);
+    }
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return Allocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return Allocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    auto p = AllocateAligned(size, alignment);
+    while (p == nullptr)
+    {
+        HandleOutOfMemory();
+        p = AllocateAligned(size, alignment);
+    }
+    return p;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return AllocateAligned(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return AllocateAligned(size, alignment);
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    FreeAligned(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    FreeAligned(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+    FreeAligned(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept {
+    FreeAligned(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    FreeAligned(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept {
+    FreeAligned(p);
+}
+
+static void Split(benchmark::State& state) {
+    const auto& s = GetCorpus((size_t)state.range(0), state.range(1), 0, ", ");
+    const auto allocationsBefore = Allocations();
+    for (auto _ : state)
+    { benchmark::DoNotOptimize(StringUtils::Split(s, ',')); }
+    Report(state, s.length(), allocationsBefore);
+}
+BENCHMARK(Split)->ArgsProduct({sizes, densities});
+
+static void SplitMultiCharacter(benchmark::State& state) {
+    const auto& s = GetCorpus((size_t)state.range(0), state.range(1), 0, "\r\n");
+    const std::string d = "\r\n";
+    const auto allocationsBefore = Allocations();
+    for (auto _ : state)
+    { benchmark::DoNotOptimize(StringUtils::Split(s, d)); }
+    Report(state, s.length(), allocationsBefore);
+}
+BENCHMARK(SplitMultiCharacter)->ArgsProduct({sizes, densities});
+
+static void SplitFile(benchmark::State& state) {
+    const auto& s = GetCorpus((size_t)state.range(0), state.range(1), 0, ", ");
+    const std::string path = "StringUtilsBenchmarks.txt";
+    const auto file = fopen(path.c_str(), "wb");
+    if (file == nullptr)
+    {
+        state.SkipWithError("unable to write input file");
+        return;
+    }
+    (void)fwrite(s.data(), 1, s.length(), file);
+    (void)fclose(file);
+    const auto allocationsBefore = Allocations();
+    for (auto _ : state)
+    {
+        for (auto piece : StringUtils::SplitFile(path, ','))
+        { benchmark::DoNotOptimize(piece); }
+    }
+    Report(state, s.length(), allocationsBefore);
+    (void)remove(path.c_str());
+}
+BENCHMARK(SplitFile)->ArgsProduct({sizes, densities});
+
+static void StreamSplitter(benchmark::State& state) {
+    const auto& s = GetCorpus((size_t)state.range(0), state.range(1), 0, "\r\n");
+    const auto chunkSize = (size_t)state.range(2);
+    size_t pieces = 0;
+    StringUtils::StreamSplitter splitter("\r\n", [&pieces](std::string_view) { ++pieces; });
+    const auto allocationsBefore = Allocations();
+    for (auto _ : state)
+    {
+        for (size_t chunkBegin = 0; chunkBegin < s.length(); chunkBegin += chunkSize)
+        { splitter.Feed(std::string_view(s).substr(chunkBegin, chunkSize)); }
+        splitter.Finish();
+    }
+    benchmark::DoNotOptimize(pieces);
+    Report(state, s.length(), allocationsBefore);
+}
+BENCHMARK(StreamSplitter)->ArgsProduct({sizes, densities, {1500, 65536}});
+
+static void Join(benchmark::State& state) {
+    const auto& s = GetCorpus((size_t)state.range(0), state.range(1), 0, ",");
+    const auto pieces = StringUtils::Split(s, ',');
+    const auto allocationsBefore = Allocations();
+    for (auto _ : state)
+    { benchmark::DoNotOptimize(StringUtils::Join(pieces, ',')); }
+    Report(state, s.length(), allocationsBefore);
+}
+BENCHMARK(Join)->ArgsProduct({sizes, densities});
+
+static void ParallelSplit(benchmark::State& state) {
+    const auto& s = GetCorpus((size_t)state.range(0), 100, 0, ", ");
+    const auto threads = (size_t)state.range(1);
+    const auto allocationsBefore = Allocations();
+    for (auto _ : state)
+    { benchmark::DoNotOptimize(StringUtils::ParallelSplit(s, ',', threads)); }
+    Report(state, s.length(), allocationsBefore);
+}
+BENCHMARK(ParallelSplit)
+    ->ArgsProduct({benchmark::CreateRange(1 << 20, 64 << 20, 8), {1, 2, 4, 8, 16}})
+    ->UseRealTime();
+
+static void ParallelJoin(benchmark::State& state) {
+    const auto& s = GetCorpus((size_t)state.range(0), 100, 0, ",");
+    const auto pieces = StringUtils::Split(s, ',');
+    const auto threads = (size_t)state.range(1);
+    const auto allocationsBefore = Allocations();
+    for (auto _ : state)
+    { benchmark::DoNotOptimize(StringUtils::ParallelJoin(pieces, ",", threads)); }
+    Report(state, s.length(), allocationsBefore);
+}
+BENCHMARK(ParallelJoin)
+    ->ArgsProduct({benchmark::CreateRange(1 << 20, 64 << 20, 8), {1, 2, 4, 8, 16}})
+    ->UseRealTime();
+
+static void Trim(benchmark::State& state) {
+    const auto size = (size_t)state.range(0);
+    const auto margin = size * (size_t)state.range(1) / 2000;
+    auto s = GetCorpus(size - 2 * margin, 0, 0, " ");
+    s.insert(0, margin, ' ');
+    s.append(margin, '\t');
+    const auto allocationsBefore = Allocations();
+    for (auto _ : state)
+    { benchmark::DoNotOptimize(StringUtils::Trim(s)); }
+    Report(state, s.length(), allocationsBefore);
+}
+BENCHMARK(Trim)->ArgsProduct({sizes, densities});
+
+static void Escape(benchmark::State& state) {
+    const auto& s = GetCorpus((size_t)state.range(0), state.range(1), state.range(2), ",;");
+    const std::set<char> charactersToEscape = {',', ';'};
+    const auto allocationsBefore = Allocations();
+    for (auto _ : state)
+    { benchmark::DoNotOptimize(StringUtils::Escape(s, '\\', charactersToEscape)); }
+    Report(state, s.length(), allocationsBefore);
+}
+BENCHMARK(Escape)->ArgsProduct({sizes, densities, escapeDensities});
+
+static void Unescape(benchmark::State& state) {
+    const auto& s = GetCorpus((size_t)state.range(0), state.range(1), state.range(2), ",;");
+    const auto allocationsBefore = Allocations();
+    for (auto _ : state)
+    { benchmark::DoNotOptimize(StringUtils::Unescape(s, '\\')); }
+    Report(state, s.length(), allocationsBefore);
+}
+BENCHMARK(Unescape)->ArgsProduct({sizes, densities, escapeDensities});
+
+static void ParseComponent(benchmark::State& state) {
+    const auto& s = GetCorpus((size_t)state.range(0), state.range(1), state.range(2), ",,,=");
+    const auto allocationsBefore = Allocations();
+    for (auto _ : state)
+    {
+        for (size_t begin = 0; begin < s.length();)
+        {
+            const auto component = StringUtils::ParseComponent(s, begin, s.length());
+            benchmark::DoNotOptimize(component);
+            begin += component.length() + 1;
+        }
+    }
+    Report(state, s.length(), allocationsBefore);
+}
+BENCHMARK(ParseComponent)->ArgsProduct({sizes, densities, escapeDensities});
+
+static void ToInteger(benchmark::State& state) {
+    const auto size = (size_t)state.range(0);
+    std::mt19937 generator(0x5eed);
+    std::uniform_int_distribution<intmax_t> value(-1000000000, 1000000000);
+    std::vector<std::string> numbers;
+    size_t length = 0;
+    while (length < size)
+    {
+        numbers.push_back(std::to_string(value(generator)));
+        length += numbers.back().length();
+    }
+    const auto allocationsBefore = Allocations();
+    for (auto _ : state)
+    {
+        for (const auto& number : numbers)
+        {
+            intmax_t result;
+            benchmark::DoNotOptimize(StringUtils::ToInteger(number, result));
+            benchmark::DoNotOptimize(result);
+        }
+    }
+    Report(state, length, allocationsBefore);
+}
+BENCHMARK(ToInteger)->ArgsProduct({sizes});
+
+static void InstantiateTemplate(benchmark::State& state) {
+    const auto& text = GetCorpus((size_t)state.range(0), state.range(1), 0, "$");
+    std::string templateText;
+    templateText.reserve(text.length() * 2);
+    for (auto c : text)
+    {
+        if (c == '$')
+        {
+            templateText += "${name}";
+        } else
+        { templateText += c; }
+    }
+    const std::map<std::string, std::string> variables = {{"name", "value"}};
+    const auto allocationsBefore = Allocations();
+    for (auto _ : state)
+    { benchmark::DoNotOptimize(StringUtils::InstantiateTemplate(templateText, variables)); }
+    Report(state, templateText.length(), allocationsBefore);
+}
+BENCHMARK(InstantiateTemplate)->ArgsProduct({sizes, densities});
+
+static void InstantiateShortTemplate(benchmark::State& state) {
+    const std::string templateText = "Hello, ${who}!  Your order ${order} ships ${when}.";
+    const std::map<std::string, std::string> variables = {
+        {"who", "World"},
+        {"order", "#12345"},
+        {"when", "tomorrow"},
+    };
+    const auto allocationsBefore = Allocations();
+    for (auto _ : state)
+    { benchmark::DoNotOptimize(StringUtils::InstantiateTemplate(templateText, variables)); }
+    Report(state, templateText.length(), allocationsBefore);
+}
+BENCHMARK(InstantiateShortTemplate);
+
+static void RenderCompiledTemplate(benchmark::State& state) {
+    const auto& text = GetCorpus((size_t)state.range(0), state.range(1), 0, "$");
+    std::string templateText;
+    templateText.reserve(text.length() * 2);
+    for (auto c : text)
+    {
+        if (c == '$')
+        {
+            templateText += "${name}";
+        } else
+        { templateText += c; }
+    }
+    const StringUtils::CompiledTemplate compiledTemplate(templateText);
+    const std::map<std::string, std::string> variables = {{"name", "value"}};
+    const auto allocationsBefore = Allocations();
+    for (auto _ : state)
+    { benchmark::DoNotOptimize(compiledTemplate.Render(variables)); }
+    Report(state, templateText.length(), allocationsBefore);
+}
+BENCHMARK(RenderCompiledTemplate)->ArgsProduct({sizes, densities});
+
+static void Indent(benchmark::State& state) {
+    const auto& s = GetCorpus((size_t)state.range(0), state.range(1), 0, "\n");
+    const auto allocationsBefore = Allocations();
+    for (auto _ : state)
+    { benchmark::DoNotOptimize(StringUtils::Indent(s, 4, StringUtils::LineEnding::Lf)); }
+    Report(state, s.length(), allocationsBefore);
+}
+BENCHMARK(Indent)->ArgsProduct({sizes, densities});
+
+static void Tolower(benchmark::State& state) {
+    const auto& s = GetCorpus((size_t)state.range(0), state.range(1), 0, "\xc3\xa9 ");
+    const auto allocationsBefore = Allocations();
+    for (auto _ : state)
+    { benchmark::DoNotOptimize(StringUtils::Tolower(s)); }
+    Report(state, s.length(), allocationsBefore);
+}
+BENCHMARK(Tolower)->ArgsProduct({sizes, densities});
+
+static void StripMarginWhitespace(benchmark::State& state) {
+    const auto& s = GetCorpus((size_t)state.range(0), state.range(1), 0, " \t\r\n");
+    const auto allocationsBefore = Allocations();
+    for (auto _ : state)
+    { benchmark::DoNotOptimize(StringUtils::StripMarginWhitespace(s)); }
+    Report(state, s.length(), allocationsBefore);
+}
+BENCHMARK(StripMarginWhitespace)->ArgsProduct({sizes, densities});
+
+static void sprintf(benchmark::State& state) {
+    const auto& s = GetCorpus((size_t)state.range(0), 0, 0, " ");
+    const auto allocationsBefore = Allocations();
+    for (auto _ : state)
+    { benchmark::DoNotOptimize(StringUtils::sprintf("%s=%d", s.c_str(), 42)); }
+    Report(state, s.length(), allocationsBefore);
+}
+BENCHMARK(sprintf)->ArgsProduct({sizes});
+
+static void CaseInsensitiveLookup(benchmark::State& state) {
+    const auto& s = GetCorpus((size_t)state.range(0), state.range(1), 0, ",");
+    const auto keys = StringUtils::SplitView(s, ',');
+    std::unordered_map<
+        std::string_view,
+        size_t,
+        StringUtils::CaseInsensitiveHash,
+        StringUtils::CaseInsensitiveEqual
+    > map;
+    for (const auto& key : keys)
+    { (void)map.emplace(key, map.size()); }
+    const auto allocationsBefore = Allocations();
+    for (auto _ : state)
+    {
+        for (const auto& key : keys)
+        { benchmark::DoNotOptimize(map.find(key)); }
+    }
+    Report(state, s.length(), allocationsBefore);
+}
+BENCHMARK(CaseInsensitiveLookup)->ArgsProduct({sizes, densities});
+
+static void CaseInsensitiveLookupStringKeys(benchmark::State& state) {
+    const auto& s = GetCorpus((size_t)state.range(0), state.range(1), 0, ",");
+    const auto keys = StringUtils::SplitView(s, ',');
+    std::unordered_map<
+        std::string,
+        size_t,
+        StringUtils::CaseInsensitiveHash,
+        StringUtils::CaseInsensitiveEqual
+    > map;
+    for (const auto& key : keys)
+    { (void)map.emplace(key, map.size()); }
+    const auto allocationsBefore = Allocations();
+    for (auto _ : state)
+    {
+        for (const auto& key : keys)
+        { benchmark::DoNotOptimize(map.find(std::string(key))); }
+    }
+    Report(state, s.length(), allocationsBefore);
+}
+BENCHMARK(CaseInsensitiveLookupStringKeys)->ArgsProduct({sizes, densities});
+
+static void NormalizedLookup(benchmark::State& state) {
+    const auto& s = GetCorpus((size_t)state.range(0), state.range(1), 0, ",");
+    const auto keys = StringUtils::SplitView(s, ',');
+    std::unordered_map<std::string, size_t> map;
+    for (const auto& key : keys)
+    {
+        const auto normalizedKey = StringUtils::NormalizeCaseInsensitiveString(std::string(key));
+        (void)map.emplace(normalizedKey, map.size());
+    }
+    const auto allocationsBefore = Allocations();
+    for (auto _ : state)
+    {
+        for (const auto& key : keys)
+        {
+            benchmark::DoNotOptimize(
+                map.find(StringUtils::NormalizeCaseInsensitiveString(std::string(key)))
+            );
+        }
+    }
+    Report(state, s.length(), allocationsBefore);
+}
+BENCHMARK(NormalizedLookup)->ArgsProduct({sizes, densities});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,157 @@
+#ifndef STRING_UTILS_INSTRUMENTATION_HPP
+#define STRING_UTILS_INSTRUMENTATION_HPP
+/**
+ * @file Instrumentation.hpp
+ *
+ * This module contains the declaration of the StringUtils::Instrumentation
+ * functions, which report statistics about calls to StringUtils functions.
+ *
+ * Statistics are only recorded when the library is built with the
+ * STRING_UTILS_INSTRUMENTATION option; otherwise the recording compiles
+ * out completely, and these functions report that nothing was called.
+ *
+ * © 2024 by Hatem Nabli
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <array>
+#include <string>
+#include <vector>
+
+namespace StringUtils
+{
+    namespace Instrumentation
+    {
+        /**
+         * This indicates whether or not the library was built
+         * to record statistics.
+         */
+#if defined(STRING_UTILS_INSTRUMENTATION)
+        constexpr bool Enabled = true;
+#else
+        constexpr bool Enabled = false;
+#endif
+
+        /**
+         * These are the families of functions for which statistics
+         * are recorded.  Each covers all the overloads and variants of
+         * the function, such as those returning views or std::pmr strings.
+         */
+        enum class Function
+        {
+            Split,
+            Join,
+            Trim,
+            Escape,
+            Unescape,
+            ParseComponent,
+            ToInteger,
+            InstantiateTemplate,
+            Indent,
+            Tolower,
+            StripMarginWhitespace,
+            sprintf,
+
+            /**
+             * This is the number of functions, not a function.
+             */
+            Count
+        };
+
+        /**
+         * This is the number of buckets in each latency histogram.
+         * Bucket N counts calls taking at least 2^N nanoseconds
+         * but less than 2^(N+1), except that the first bucket
+         * also counts calls under a nanosecond, and the last
+         * bucket also counts all longer calls.
+         */
+        constexpr size_t LatencyBuckets = 40;
+
+        /**
+         * This holds the statistics recorded for one family of functions.
+         */
+        struct FunctionStatistics
+        {
+            /**
+             * This is the family of functions to which the statistics apply.
+             */
+            Function function = Function::Split;
+
+            /**
+             * This is the number of calls made.
+             */
+            uint64_t calls = 0;
+
+            /**
+             * This is the total number of bytes of input passed in the calls.
+             */
+            uint64_t inputBytes = 0;
+
+            /**
+             * This is the total number of bytes of text produced by the calls.
+             */
+            uint64_t outputBytes = 0;
+
+            /**
+             * This is the total number of memory allocations counted
+             * by CountAllocation during the calls.
+             */
+            uint64_t allocations = 0;
+
+            /**
+             * This is the histogram of how long the calls took.
+             */
+            std::array<uint64_t, LatencyBuckets> latency = {};
+        };
+
+        /**
+         * This function returns the name of the given family of functions.
+         *
+         * @param[in] function
+         *      This is the family of functions whose name to return.
+         *
+         * @return
+         *      The name of the given family of functions is returned.
+         */
+        const char* GetFunctionName(Function function);
+
+        /**
+         * This function adds up the statistics recorded by every thread
+         * since the last reset.
+         *
+         * @return
+         *      The statistics for each family of functions are returned,
+         *      in the order the families are listed in Function.
+         */
+        std::vector<FunctionStatistics> GetStatistics();
+
+        /**
+         * This function starts the statistics over from zero.
+         */
+        void Reset();
+
+        /**
+         * This function returns the statistics recorded by every thread
+         * since the last reset, as a JSON object with a "functions" array
+         * holding an object for each family of functions.
+         *
+         * @return
+         *      The statistics are returned in JSON format.
+         */
+        std::string Dump();
+
+        /**
+         * This function is to be called by the application for each
+         * memory allocation it makes, typically from a replacement of the
+         * global operator new, so that allocations made by StringUtils
+         * functions can be attributed to them.
+         */
+#if defined(STRING_UTILS_INSTRUMENTATION)
+        void CountAllocation();
+#else
+        inline void CountAllocation() {}
+#endif
+    }  // namespace Instrumentation
+}  // namespace StringUtils
+
+#endif /*STRING_UTILS_INSTRUMENTATION_HPP*/
@@ -0,0 +1,184 @@
+#ifndef STRING_UTILS_MAPPED_FILE_HPP
+#define STRING_UTILS_MAPPED_FILE_HPP
+/**
+ * @file MappedFile.hpp
+ *
+ * This module contains the declaration of the StringUtils::MappedFile
+ * class, which maps a file into memory so that its contents can be
+ * read as a string without copying them, and of the SplitFile function,
+ * which splits the contents of a file mapped this way.
+ *
+ * © 2024 by Hatem Nabli
+ */
+#include <StringUtils\StringUtils.hpp>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace StringUtils
+{
+    /**
+     * This class maps the contents of a file into memory, read-only,
+     * for as long as it's open.  The operating system reads the file in
+     * as its contents are accessed, and is told they will be accessed in
+     * order, so pages already read may be dropped again.
+     */
+    class MappedFile
+    {
+        // Lifecycle management
+    public:
+        ~MappedFile() noexcept;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile(MappedFile&&) noexcept;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile& operator=(MappedFile&&) noexcept;
+
+        // Public methods
+    public:
+        /**
+         * This is the default constructor, which constructs
+         * a mapped file which isn't open.
+         */
+        MappedFile();
+
+        /**
+         * This method maps the file at the given path into memory,
+         * closing any file already mapped.
+         *
+         * @param[in] path
+         *     This is the path of the file to map, in UTF-8.
+         *
+         * @return
+         *     An indication of whether or not the file was mapped
+         *     successfully is returned.
+         */
+        bool Open(const std::string& path);
+
+        /**
+         * This method unmaps the file, if it's open.  Views of its
+         * contents may no longer be used.
+         */
+        void Close();
+
+        /**
+         * This method indicates whether or not the file is open.
+         *
+         * @return
+         *     An indication of whether or not the file is open is returned.
+         */
+        bool IsOpen() const;
+
+        /**
+         * This method returns a view of the contents of the file, which
+         * remains valid until the file is closed.  A file which isn't
+         * open has no contents.
+         *
+         * @return
+         *     A view of the contents of the file is returned.
+         */
+        std::string_view GetContents() const;
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance. It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr<Impl> impl_;
+    };
+
+    /**
+     * This class is the result of SplitFile.  It owns a mapped file, and
+     * is an input range whose elements are views of the pieces of the
+     * file's contents, found as the range is iterated, exactly as
+     * SplitRange finds them.  The pieces remain valid as long as the
+     * range exists, even if it's moved.
+     */
+    class MappedSplit
+    {
+        // Public methods
+    public:
+        /**
+         * This constructs the range over the contents of the given file,
+         * taking ownership of it.
+         *
+         * @param[in] file
+         *     This is the file whose contents to split.
+         *
+         * @param[in] d
+         *     This is the delimiter character at which to split
+         *     the contents.
+         */
+        MappedSplit(MappedFile&& file, char d);
+
+        /**
+         * This method indicates whether or not the file was opened.
+         *
+         * @return
+         *     An indication of whether or not the file is open is returned.
+         */
+        bool IsOpen() const;
+
+        /**
+         * This method returns the mapped file whose contents are split.
+         *
+         * @return
+         *     The mapped file is returned.
+         */
+        const MappedFile& GetFile() const;
+
+        /**
+         * This method returns an iterator to the first piece.
+         *
+         * @return
+         *     An iterator to the first piece is returned.
+         */
+        SplitRange::Iterator begin() const;
+
+        /**
+         * This method returns an iterator past the last piece.
+         *
+         * @return
+         *     An iterator past the last piece is returned.
+         */
+        SplitRange::Iterator end() const;
+
+        // Private properties
+    private:
+        /**
+         * This is the mapped file whose contents are split.
+         */
+        MappedFile file;
+
+        /**
+         * These are the pieces of the file's contents.
+         */
+        SplitRange pieces;
+    };
+
+    /**
+     * This function maps the file at the given path into memory and
+     * breaks its contents at each instance of the given delimiter, as
+     * Split does, without reading the file into a string.  The pieces
+     * are views into the mapping, which lasts as long as the result.
+     *
+     * @param[in] path
+     *     This is the path of the file to split, in UTF-8.
+     *
+     * @param[in] d
+     *     This is the delimiter character at which to split the file.
+     *
+     * @return
+     *     The range of pieces is returned.  If the file could not be
+     *     opened, the range is empty, and its IsOpen method returns false.
+     */
+    MappedSplit SplitFile(const std::string& path, char d);
+}  // namespace StringUtils
+
+#endif /*STRING_UTILS_MAPPED_FILE_HPP*/
@@ -11,13 +11,19 @@
 #include <stdlib.h>
 #include <inttypes.h>
 #include <ctype.h>
+#include <functional>
+#include <iterator>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <vector>
 #include <set>
 #include <map>
+#include <memory_resource>
+#include <unordered_map>
 #include <limits>
+#include <type_traits>
 
 namespace StringUtils
 {
@@ -45,6 +51,130 @@ namespace StringUtils
         Overflow
     };
 
+    /**
+     * These are the different results that can be indicated
+     * when a string is parsed as a floating-point number.
+     */
+    enum class ToDoubleResult
+    {
+        /**
+         * This indicates the number was parsed successfully.
+         */
+        Success,
+
+        /**
+         * This indicates the number was not in decimal notation.
+         */
+        NotANumber,
+
+        /**
+         * This indicates the number was too large in magnitude
+         * to be represented.
+         */
+        Overflow,
+
+        /**
+         * This indicates the number was too small in magnitude
+         * to be represented, but was not zero.
+         */
+        Underflow
+    };
+
+    /**
+     * This class builds up a string piece by piece.  Its storage grows
+     * geometrically, or may be reserved up front when the final length
+     * is known, and the finished string is handed over without a copy.
+     */
+    class StringBuilder
+    {
+        // Public methods
+    public:
+        /**
+         * This method makes sure the builder can hold at least the given
+         * total number of characters without allocating more memory.
+         *
+         * @param[in] capacity
+         *     This is the total number of characters to make room for.
+         */
+        void Reserve(size_t capacity) {
+            buffer.reserve(capacity);
+        }
+
+        /**
+         * This method appends the given character.
+         *
+         * @param[in] c
+         *     This is the character to append.
+         */
+        void Append(char c) {
+            buffer.push_back(c);
+        }
+
+        /**
+         * This method appends the given number of copies of the
+         * given character.
+         *
+         * @param[in] count
+         *     This is the number of copies to append.
+         *
+         * @param[in] c
+         *     This is the character to append.
+         */
+        void Append(size_t count, char c) {
+            buffer.append(count, c);
+        }
+
+        /**
+         * This method appends the given characters.
+         *
+         * @param[in] characters
+         *     These are the characters to append.
+         */
+        void Append(std::string_view characters) {
+            buffer.append(characters.data(), characters.length());
+        }
+
+        /**
+         * This method returns the number of characters appended so far.
+         *
+         * @return
+         *     The number of characters appended so far is returned.
+         */
+        size_t GetLength() const {
+            return buffer.length();
+        }
+
+        /**
+         * This method returns a view of the characters appended so far.
+         *
+         * @return
+         *     A view of the characters appended so far is returned.
+         */
+        std::string_view GetView() const {
+            return buffer;
+        }
+
+        /**
+         * This method hands over the string built, leaving the
+         * builder empty.
+         *
+         * @return
+         *     The string built is returned.
+         */
+        std::string Finish() {
+            std::string result(std::move(buffer));
+            buffer.clear();
+            return result;
+        }
+
+        // Private properties
+    private:
+        /**
+         * This holds the characters appended so far.
+         */
+        std::string buffer;
+    };
+
     /**
      * This fucntion is equivalent to the sprintf function in the standard C
      * library, except tha it constructs the string dynamically and
@@ -59,6 +189,220 @@ namespace StringUtils
      */
     std::string vsprintf(const char* format, va_list args);
 
+    /**
+     * This class holds one value to be formatted by the Format function,
+     * along with an indication of its type, so that the values can be
+     * handed to the formatter as an array, without the type-unsafety of
+     * a variable argument list.
+     */
+    class FormatArgument
+    {
+        // Types
+    public:
+        /**
+         * These are the types of values which can be formatted.
+         */
+        enum class Type
+        {
+            Boolean,
+            Character,
+            SignedInteger,
+            UnsignedInteger,
+            Float,
+            Double,
+            String
+        };
+
+        // Lifecycle management
+    public:
+        FormatArgument(bool value) : type(Type::Boolean) {
+            boolean = value;
+        }
+
+        FormatArgument(char value) : type(Type::Character) {
+            character = value;
+        }
+
+        template <
+            typename Integer,
+            typename std::enable_if<std::is_integral<Integer>::value
+                                        && !std::is_same<Integer, bool>::value
+                                        && !std::is_same<Integer, char>::value,
+                                    int>::type = 0>
+        FormatArgument(Integer value)
+            : type(std::is_signed<Integer>::value ? Type::SignedInteger
+                                                  : Type::UnsignedInteger) {
+            if (std::is_signed<Integer>::value)
+            {
+                signedInteger = (intmax_t)value;
+            } else
+            { unsignedInteger = (uintmax_t)value; }
+        }
+
+        FormatArgument(float value) : type(Type::Float) {
+            singlePrecision = value;
+        }
+
+        FormatArgument(double value) : type(Type::Double) {
+            doublePrecision = value;
+        }
+
+        FormatArgument(std::string_view value) : type(Type::String) {
+            string.data = value.data();
+            string.length = value.length();
+        }
+
+        /**
+         * A null string is formatted as "(null)", as the C library's
+         * printf does, rather than being read.
+         */
+        FormatArgument(const char* value)
+            : FormatArgument((value == nullptr) ? std::string_view("(null)")
+                                                : std::string_view(value)) {}
+
+        FormatArgument(const std::string& value) : FormatArgument(std::string_view(value)) {}
+
+        // Public methods
+    public:
+        /**
+         * This method appends the value, formatted, to the given builder.
+         * Integers are written in decimal, and floating-point numbers in
+         * the shortest form which reads back as the same value.
+         *
+         * @param[in,out] output
+         *     This is the builder to which to append the value.
+         */
+        void AppendTo(StringBuilder& output) const;
+
+        // Private properties
+    private:
+        /**
+         * This indicates the type of the value.
+         */
+        Type type;
+
+        /**
+         * This holds the value, in the member indicated by the type.
+         */
+        union
+        {
+            bool boolean;
+            char character;
+            intmax_t signedInteger;
+            uintmax_t unsignedInteger;
+            float singlePrecision;
+            double doublePrecision;
+            struct
+            {
+                const char* data;
+                size_t length;
+            } string;
+        };
+    };
+
+    /**
+     * This function counts the "{}" placeholders in the given format
+     * string, as used by Format.  "{{" and "}}" stand for literal braces.
+     * It can be evaluated at compile time.
+     *
+     * @param[in] format
+     *     This is the format string to check.
+     *
+     * @return
+     *     The number of placeholders is returned, or std::string_view::npos
+     *     if the format string has a brace which isn't part of a
+     *     placeholder or an escaped brace.
+     */
+    constexpr size_t CountFormatPlaceholders(std::string_view format) {
+        size_t count = 0;
+        for (size_t i = 0; i < format.length(); ++i)
+        {
+            const auto next = ((i + 1 < format.length()) ? format[i + 1] : '\0');
+            if (format[i] == '{')
+            {
+                if (next == '}')
+                {
+                    ++count;
+                } else if (next != '{')
+                { return std::string_view::npos; }
+                ++i;
+            } else if (format[i] == '}')
+            {
+                if (next != '}')
+                { return std::string_view::npos; }
+                ++i;
+            }
+        }
+        return count;
+    }
+
+    /**
+     * This function formats the given values into a string, according to
+     * the given format string, in which each "{}" is replaced by the next
+     * value, and "{{" and "}}" stand for literal braces.  Placeholders
+     * without values are left as they are, and values without placeholders
+     * are ignored.
+     *
+     * @param[in] format
+     *     This is the format string.
+     *
+     * @param[in] arguments
+     *     These are the values to format.
+     *
+     * @param[in] count
+     *     This is the number of values to format.
+     *
+     * @return
+     *     The formatted string is returned.
+     */
+    std::string FormatArguments(std::string_view format, const FormatArgument* arguments,
+                                size_t count);
+
+    /**
+     * This function formats the given values into a string, according to
+     * the given format string, in which each "{}" is replaced by the next
+     * value.  Values may be booleans, characters, integers, floating-point
+     * numbers or strings, and are formatted by dedicated routines rather
+     * than through a variable argument list.
+     *
+     * Use the STRING_UTILS_FORMAT macro to have the format string checked
+     * against the values at compile time.
+     *
+     * @param[in] format
+     *     This is the format string.
+     *
+     * @param[in] values
+     *     These are the values to format.
+     *
+     * @return
+     *     The formatted string is returned.
+     */
+    template <typename... Values>
+    std::string Format(std::string_view format, const Values&... values) {
+        const FormatArgument arguments[] = {FormatArgument(values)..., FormatArgument(false)};
+        return FormatArguments(format, arguments, sizeof...(Values));
+    }
+
+    /**
+     * This function is never called, but its type gives the number of
+     * arguments given to it, for use by the STRING_UTILS_FORMAT macro.
+     */
+    template <typename... Arguments>
+    std::integral_constant<size_t, sizeof...(Arguments)> ArgumentCount(const Arguments&...);
+
+    /**
+     * This function fails to compile unless the given number of format
+     * placeholders is valid and matches the given number of values.
+     */
+    template <size_t placeholders, size_t values>
+    constexpr bool CheckFormatArguments() {
+        static_assert(placeholders != std::string_view::npos,
+                      "format string has a brace which is not part of a placeholder");
+        static_assert(placeholders == values,
+                      "number of format placeholders does not match number of values");
+        return true;
+    }
+
     /**
      * This method convert a given string from wide (UNICODE) to
      * narrow (multibyte) format, using the currently set locale.
@@ -74,192 +418,1968 @@ namespace StringUtils
     std::string wcstombs(const std::wstring& src);
 
     /**
-     * This method makes a copy of a string and removes any whitespace
-     * from the front and back of the copy.
+     * These are the different results that can be indicated
+     * when text is validated or converted from one Unicode
+     * encoding to another.
+     */
+    enum class UtfResult
+    {
+        /**
+         * This indicates the text was valid, and converted if asked.
+         */
+        Success,
+
+        /**
+         * This indicates the text had a sequence of code units which is
+         * not valid in its encoding, such as an overlong or unfinished
+         * UTF-8 sequence, an unpaired UTF-16 surrogate, or a value
+         * which is not a Unicode scalar value.
+         */
+        InvalidSequence,
+
+        /**
+         * This indicates the text ended part way through a sequence
+         * which was valid so far.
+         */
+        Truncated
+    };
+
+    /**
+     * This function checks whether or not the given text is valid UTF-8.
+     * Runs of ASCII characters are checked a block at a time.
      *
-     * @param[in] s
-     *      This is the string to trim.
+     * @param[in] utf8
+     *     This is the text to check.
+     *
+     * @param[out] errorOffset
+     *     This is where to store the offset of the sequence which is not
+     *     valid, or the length of the text if it's all valid.
      *
      * @return
-     *      The trimed string is returned.
+     *     An indication of whether or not the text is valid is returned.
      */
-    std::string Trim(const std::string& s);
+    UtfResult ValidateUtf8(std::string_view utf8, size_t& errorOffset);
 
     /**
-     * This function breaks up the given string into lines,
-     * according to any CR-LF end-of-line character sequences found
-     * in the string, indents all lines except the first,
-     * and then concatenates the lines back together, returning
-     * them as a single string.
-     *
-     * @param[in] linesIn
-     *      This is the string containing the lines to indent.
+     * This function checks whether or not the given text is valid UTF-8.
      *
-     * @param[in] spaces
-     *      This is the number of spaces to indent each line but the first.
+     * @param[in] utf8
+     *     This is the text to check.
      *
      * @return
-     *      returns the indented text as a single string.
+     *     An indication of whether or not the text is valid is returned.
      */
-    std::string Indent(std::string linesIn, size_t spaces);
+    bool IsValidUtf8(std::string_view utf8);
 
     /**
-     * This fucntion returns a substring of the given string that contains
-     * the delimited component, such as string, "array", object, etc.., pairs:
-     * " "
-     * [ ]
-     * { }
-     * < >
-     * ( )
+     * This function converts the given UTF-8 text to UTF-16.
      *
-     * Escaped delimiter characters (i.e. "\{") are not considered as delimiters.
+     * All the transcoding functions work the same way, independent of the
+     * current locale.  The text is checked, and the length of the result
+     * worked out, first, so that the result is allocated only once.  Runs
+     * of ASCII characters are checked and converted in bulk.  If the text
+     * is not valid, the output is left as it was, and the offset (in code
+     * units) of the sequence which is not valid is given.
      *
-     * Any comma (',') or "outer-most" delimiter encountered while scanning
-     * the string is considered to terminate the component.
+     * @param[in] utf8
+     *     This is the text to convert.
      *
-     * @param[in] s
-     *      This is the string from which to extract the next delimited component.
+     * @param[out] utf16
+     *     This is where to store the converted text.
      *
-     * @param[in] begin
-     *      This is the starting posistion from which to scan the next component.
+     * @param[out] errorOffset
+     *     This is where to store the offset of the sequence which is not
+     *     valid, or the length of the text if it's all valid.
      *
-     * @param[in] end
-     *      This is the limit to which the string will be scanned to determine
-     *      the next component.
+     * @return
+     *     An indication of whether or not the text was converted
+     *     is returned.
      */
-    std::string ParseComponent(const std::string& s, size_t begin, size_t end);
+    UtfResult Utf8ToUtf16(std::string_view utf8, std::u16string& utf16, size_t& errorOffset);
 
     /**
-     * This function return a copie of the given input string, modifird
-     * so that every character in the given "charactersToEscape" that is
-     * found in the input string is prefixed by the given "escapeCharacter".
+     * This function converts the given UTF-8 text to UTF-32,
+     * in the same way as Utf8ToUtf16.
      *
-     * @param[in] s
-     *     This is the input string.
+     * @param[in] utf8
+     *     This is the text to convert.
      *
-     * @param[in] escapeCharacter
-     *     This is the character to put in front of every character
-     *     in the input string that is a member of the
-     *     "charactersToEscape" set.
+     * @param[out] utf32
+     *     This is where to store the converted text.
      *
-     * @param[in] charactersToEscape
-     *     These are the characters that should be escaped in the input.
+     * @param[out] errorOffset
+     *     This is where to store the offset of the sequence which is not
+     *     valid, or the length of the text if it's all valid.
      *
      * @return
-     *     A copy of the input string is returned, where every character
-     *     in the given "charactersToEscape" that is found in the input
-     *     string is prefixed by the given "escapeCharacter".
+     *     An indication of whether or not the text was converted
+     *     is returned.
      */
-    std::string Escape(const std::string& s, char escapeCharacter,
-                       const std::set<char>& charactersToEscape);
+    UtfResult Utf8ToUtf32(std::string_view utf8, std::u32string& utf32, size_t& errorOffset);
 
     /**
-     * This function removes the given escapeCharacter from the given input
-     * string.
+     * This function converts the given UTF-8 text to wide characters
+     * (UTF-16 where wchar_t is 16 bits, and UTF-32 otherwise),
+     * in the same way as Utf8ToUtf16.
      *
-     * @param[in] s
-     *      This is the string from which to remove all escape characters.
+     * @param[in] utf8
+     *     This is the text to convert.
+     *
+     * @param[out] wide
+     *     This is where to store the converted text.
+     *
+     * @param[out] errorOffset
+     *     This is where to store the offset of the sequence which is not
+     *     valid, or the length of the text if it's all valid.
      *
-     * @param[in] escapCharacter
-     *      This is the character to remove from the given input string.
      * @return
-     *      returns the given input string after removong all instances of
-     *      the given escapeCharacter.
+     *     An indication of whether or not the text was converted
+     *     is returned.
      */
-    std::string Unescape(const std::string& s, char escapeCharacter);
+    UtfResult Utf8ToWide(std::string_view utf8, std::wstring& wide, size_t& errorOffset);
 
     /**
-     * This function break the given string at each instance of the
-     * given delimiter, returning the pieces as a collection of
-     * substrings. Tha delimiter charachters are removed.
+     * This function converts the given UTF-16 text to UTF-8,
+     * in the same way as Utf8ToUtf16.
+     *
+     * @param[in] utf16
+     *     This is the text to convert.
+     *
+     * @param[out] utf8
+     *     This is where to store the converted text.
+     *
+     * @param[out] errorOffset
+     *     This is where to store the offset of the sequence which is not
+     *     valid, or the length of the text if it's all valid.
      *
-     * @param[in] s
-     *       This is the string to split.
-     * @param[in] d
-     *       This is the delimiter character at which to split the string.
      * @return
-     *       returns the collection of substrings that result from breaking
-     *       the given string at each delimiter character.
+     *     An indication of whether or not the text was converted
+     *     is returned.
      */
-    std::vector<std::string> Split(const std::string& s, char d);
+    UtfResult Utf16ToUtf8(std::u16string_view utf16, std::string& utf8, size_t& errorOffset);
 
     /**
-     * This function break the given string at each instance of the
-     * given delimiter, returning the pieces as a collection of
-     * substrings. Tha delimiter charachters are removed.
+     * This function converts the given UTF-32 text to UTF-8,
+     * in the same way as Utf8ToUtf16.
+     *
+     * @param[in] utf32
+     *     This is the text to convert.
+     *
+     * @param[out] utf8
+     *     This is where to store the converted text.
+     *
+     * @param[out] errorOffset
+     *     This is where to store the offset of the sequence which is not
+     *     valid, or the length of the text if it's all valid.
      *
-     * @param[in] s
-     *       This is the string to split.
-     * @param[in] d
-     *       This is the delimiter string at which to split the string.
      * @return
-     *       returns the collection of substrings that result from breaking
-     *       the given string at each delimiter string.
+     *     An indication of whether or not the text was converted
+     *     is returned.
      */
-    std::vector<std::string> Split(const std::string& s, const std::string& d);
+    UtfResult Utf32ToUtf8(std::u32string_view utf32, std::string& utf8, size_t& errorOffset);
 
     /**
-     * This function take the given sequence of substrings to
-     * concatenate them together into a formel string, each piece separated by
-     * the given delimiter character.
+     * This function converts the given wide character text (UTF-16 where
+     * wchar_t is 16 bits, and UTF-32 otherwise) to UTF-8, in the same way
+     * as Utf8ToUtf16.  Unlike wcstombs, this does not depend on
+     * the current locale.
      *
-     * @param[in] v
-     *        This is the sequence of substrings to join together.
+     * @param[in] wide
+     *     This is the text to convert.
+     *
+     * @param[out] utf8
+     *     This is where to store the converted text.
+     *
+     * @param[out] errorOffset
+     *     This is where to store the offset of the sequence which is not
+     *     valid, or the length of the text if it's all valid.
      *
-     * @param[in] d
-     *        This is the delimiter character used as glue between
-     *        substrings.
      * @return
-     *        returns a string formed formed from the concatenation
-     *        of the sequece of substrings separeted by the given
-     *        delimiter character.
+     *     An indication of whether or not the text was converted
+     *     is returned.
      */
-    std::string Join(const std::vector<std::string>& v, const char d);
+    UtfResult WideToUtf8(std::wstring_view wide, std::string& utf8, size_t& errorOffset);
 
     /**
-     * This function take the given sequence of substrings to
-     * concatenate them together into a formel string, each piece separated by
-     * the given delimiter character.
+     * These are the sets of characters which trimming functions
+     * may consider to be whitespace.
+     */
+    enum class WhitespaceClass
+    {
+        /**
+         * This is every character whose code, as a (signed) char, is
+         * 32 or less: the space, ASCII control characters, and every
+         * character which is not ASCII.  This is what Trim has always
+         * considered whitespace.
+         */
+        Control,
+
+        /**
+         * This is the characters the C "isspace" function considers
+         * whitespace in the "C" locale: space, tab, line feed,
+         * vertical tab, form feed and carriage return.
+         */
+        Space
+    };
+
+    /**
+     * This method makes a copy of a string and removes any whitespace
+     * from the front and back of the copy.
      *
-     * @param[in] v
-     *        This is the sequence of substrings to join together.
+     * @param[in] s
+     *      This is the string to trim.
+     *
+     * @param[in] whitespace
+     *      This is the set of characters to consider whitespace.
      *
-     * @param[in] d
-     *        This is the delimiter character used as glue between
-     *        substrings.
      * @return
-     *        returns a string formed formed from the concatenation
-     *        of the sequece of substrings separeted by the given
-     *        delimiter character.
+     *      The trimed string is returned.
      */
-    std::string Join(const std::vector<std::string>& v, const std::string& d);
+    std::string Trim(const std::string& s, WhitespaceClass whitespace = WhitespaceClass::Control);
 
     /**
-     * This function check each character of the given string
-     * to convert them to lower-case.
+     * This method returns a view of the given string with any whitespace
+     * removed from the front and back.  No copy of the string is made.
+     * Long runs of whitespace, such as the padding of fixed-width
+     * records, are skipped a block at a time.
      *
      * @param[in] s
-     *      This is the string to check and to convert to lower-case.
+     *      This is the string to trim.
+     *
+     * @param[in] whitespace
+     *      This is the set of characters to consider whitespace.
+     *
      * @return
-     *      Returns the given string in lower-case style
+     *      A view of the trimmed portion of the given string is returned.
      */
-    std::string Tolower(const std::string& s);
+    std::string_view TrimView(std::string_view s,
+                              WhitespaceClass whitespace = WhitespaceClass::Control);
 
     /**
-     * This function parses the given string as an
-     * integer, detecting invalid characters, overflow, etc.
+     * This method removes any whitespace from the front and back
+     * of the given string, without making a copy of it.
      *
-     * @param[in] numberString
-     *     This is the string containing the number to parse.
+     * @param[in,out] s
+     *      This is the string to trim.
+     *
+     * @param[in] whitespace
+     *      This is the set of characters to consider whitespace.
+     */
+    void TrimInPlace(std::string& s, WhitespaceClass whitespace = WhitespaceClass::Control);
+
+    /**
+     * This function is the same as Trim, except that the trimmed copy
+     * is allocated from the given memory resource.
+     *
+     * @param[in] s
+     *      This is the string to trim.
+     *
+     * @param[in] resource
+     *      This is the memory resource from which to allocate the result.
+     *
+     * @return
+     *      The trimed string is returned.
+     */
+    std::pmr::string Trim(std::string_view s, std::pmr::memory_resource* resource);
+
+    /**
+     * These are the ways lines of text may be terminated.
+     */
+    enum class LineEnding
+    {
+        /**
+         * This indicates lines end only with a carriage return
+         * followed by a line feed.
+         */
+        CrLf,
+
+        /**
+         * This indicates lines end with a line feed, which may or may not
+         * be preceded by a carriage return, so that lines ending either
+         * way, or a mix of the two, are recognized.
+         */
+        Lf,
+
+        /**
+         * This indicates lines end with a line feed, a carriage return,
+         * or a carriage return followed by a line feed.
+         */
+        Any
+    };
+
+    /**
+     * This function breaks up the given string into lines,
+     * according to the end-of-line character sequences found
+     * in the string, indents all lines except the first (unless asked
+     * to indent the first too), and then concatenates the lines back
+     * together, returning them as a single string.  Line terminators
+     * are kept as they are.  Nothing follows a terminator at the very
+     * end of the string, so no indentation is added there.
+     *
+     * The length of the result is worked out first, so that it's
+     * allocated only once.
+     *
+     * @param[in] linesIn
+     *      This is the string containing the lines to indent.
+     *
+     * @param[in] spaces
+     *      This is the number of spaces to indent each line but the first.
+     *
+     * @param[in] lineEnding
+     *      This indicates how lines are terminated.
+     *
+     * @param[in] indentFirstLine
+     *      This indicates whether or not to indent the first line too.
+     *
+     * @return
+     *      returns the indented text as a single string.
+     */
+    std::string Indent(std::string_view linesIn, size_t spaces,
+                       LineEnding lineEnding = LineEnding::CrLf, bool indentFirstLine = false);
+
+    /**
+     * This function is the same as Indent, except that the indented
+     * text is appended to the given string, such as a buffer holding
+     * the rest of a generated document.
+     *
+     * @param[in,out] linesOut
+     *      This is where to append the indented text.
+     *
+     * @param[in] linesIn
+     *      This is the string containing the lines to indent.
+     *
+     * @param[in] spaces
+     *      This is the number of spaces to indent each line but the first.
+     *
+     * @param[in] lineEnding
+     *      This indicates how lines are terminated.
+     *
+     * @param[in] indentFirstLine
+     *      This indicates whether or not to indent the first line too.
+     */
+    void AppendIndented(std::string& linesOut, std::string_view linesIn, size_t spaces,
+                        LineEnding lineEnding = LineEnding::CrLf, bool indentFirstLine = false);
+
+    /**
+     * This function is the same as Indent, except that the indented
+     * text is allocated from the given memory resource.
+     *
+     * @param[in] linesIn
+     *      This is the string containing the lines to indent.
+     *
+     * @param[in] spaces
+     *      This is the number of spaces to indent each line but the first.
+     *
+     * @param[in] resource
+     *      This is the memory resource from which to allocate the result.
+     *
+     * @param[in] lineEnding
+     *      This indicates how lines are terminated.
+     *
+     * @param[in] indentFirstLine
+     *      This indicates whether or not to indent the first line too.
+     *
+     * @return
+     *      returns the indented text as a single string.
+     */
+    std::pmr::string Indent(std::string_view linesIn, size_t spaces,
+                            std::pmr::memory_resource* resource,
+                            LineEnding lineEnding = LineEnding::CrLf, bool indentFirstLine = false);
+
+    /**
+     * This fucntion returns a substring of the given string that contains
+     * the delimited component, such as string, "array", object, etc.., pairs:
+     * " "
+     * [ ]
+     * { }
+     * < >
+     * ( )
+     *
+     * Escaped delimiter characters (i.e. "\{") are not considered as delimiters.
+     *
+     * Any comma (',') or "outer-most" delimiter encountered while scanning
+     * the string is considered to terminate the component.
+     *
+     * @param[in] s
+     *      This is the string from which to extract the next delimited component.
+     *
+     * @param[in] begin
+     *      This is the starting posistion from which to scan the next component.
+     *
+     * @param[in] end
+     *      This is the limit to which the string will be scanned to determine
+     *      the next component.
+     */
+    std::string ParseComponent(const std::string& s, size_t begin, size_t end);
+
+    /**
+     * This function is the same as ParseComponent, except that it
+     * returns a view of the component within the given string rather
+     * than a copy of it.
+     *
+     * @param[in] s
+     *      This is the string from which to extract the next delimited component.
+     *
+     * @param[in] begin
+     *      This is the starting posistion from which to scan the next component.
+     *
+     * @param[in] end
+     *      This is the limit to which the string will be scanned to determine
+     *      the next component.
+     *
+     * @return
+     *      A view of the component within the given string is returned.
+     */
+    std::string_view ParseComponentView(std::string_view s, size_t begin, size_t end);
+
+    /**
+     * This function finds all the components of the given string in one
+     * pass, as if by calling ParseComponent repeatedly, starting each
+     * component one character past the end of the one before it, until a
+     * component reaches the end of the string.  The same nesting and
+     * string escape rules apply.
+     *
+     * Quotes, backslashes, brackets and commas are located a block at
+     * a time, so that only those characters need to be examined one
+     * at a time.
+     *
+     * @param[in] s
+     *      This is the string to break into components.
+     *
+     * @return
+     *      The offset of the end of each component is returned.
+     *      Component N begins one character past the end of
+     *      component N - 1, and the first component begins at zero.
+     */
+    std::vector<size_t> FindComponentEnds(std::string_view s);
+
+    /**
+     * This function is the same as FindComponentEnds, except that it
+     * returns views of the components within the given string.
+     *
+     * @param[in] s
+     *      This is the string to break into components.
+     *
+     * @return
+     *      Views of the components within the given string are returned.
+     */
+    std::vector<std::string_view> SplitComponents(std::string_view s);
+
+    /**
+     * This class is an incremental version of SplitComponents, for strings
+     * which arrive a chunk at a time.  Each component is handed to a
+     * delegate as soon as it's complete, and the components are the same
+     * as SplitComponents would return for the whole string, with nesting,
+     * quoting and escaping carried over from one chunk to the next.
+     *
+     * Only the unfinished component at the end of each chunk is kept, so
+     * memory use is bounded by the longest component rather than the string.
+     */
+    class StreamComponentSplitter
+    {
+        // Types
+    public:
+        /**
+         * This is the type of function called with each component.
+         * The component is only valid during the call.
+         */
+        using TokenDelegate = std::function<void(std::string_view token)>;
+
+        // Public methods
+    public:
+        /**
+         * This constructs the splitter.
+         *
+         * @param[in] tokenDelegate
+         *     This is the function to call with each component.
+         */
+        explicit StreamComponentSplitter(TokenDelegate tokenDelegate);
+
+        /**
+         * This method splits the next chunk of the string, handing every
+         * component it completes to the delegate.
+         *
+         * @param[in] chunk
+         *     This is the next chunk of the string.
+         */
+        void Feed(std::string_view chunk);
+
+        /**
+         * This method signals the end of the string, handing the last
+         * component, if any, to the delegate.  The splitter may then be
+         * fed another string.
+         */
+        void Finish();
+
+        /**
+         * This method returns the number of characters kept from the
+         * chunks fed so far, for the component not yet complete.
+         *
+         * @return
+         *     The number of characters kept is returned.
+         */
+        size_t GetPendingLength() const;
+
+        // Private properties
+    private:
+        /**
+         * This is the function to call with each component.
+         */
+        TokenDelegate tokenDelegate;
+
+        /**
+         * These are the characters of the unfinished component which
+         * came in earlier chunks.
+         */
+        std::string pending;
+
+        /**
+         * This is the number of characters fed so far.
+         */
+        size_t streamLength = 0;
+
+        /**
+         * This is the position in the string where the unfinished
+         * component begins.
+         */
+        size_t begin = 0;
+
+        /**
+         * This is how deeply nested the scan is within brackets,
+         * starting at one.
+         */
+        int level = 1;
+
+        /**
+         * This indicates whether or not the scan is within quotes.
+         */
+        bool inString = false;
+
+        /**
+         * This is the position in the string of the character escaped
+         * by the last backslash found within quotes, if any.
+         */
+        size_t escaped = std::string_view::npos;
+    };
+
+    /**
+     * This class holds a set of characters to escape, and the character
+     * with which to escape them, prepared once so that many strings can
+     * be escaped quickly.  Membership is kept as a 256-bit bitmap, and
+     * small sets are also kept as a list for matching a block of
+     * characters at a time.
+     */
+    class EscapeSpec
+    {
+        // Lifecycle management
+    public:
+        /**
+         * This constructs the specification from a set of characters.
+         *
+         * @param[in] escapeCharacter
+         *     This is the character to put in front of every character
+         *     to escape.
+         *
+         * @param[in] charactersToEscape
+         *     These are the characters to escape.
+         */
+        EscapeSpec(char escapeCharacter, const std::set<char>& charactersToEscape);
+
+        /**
+         * This constructs the specification from a string of characters.
+         *
+         * @param[in] escapeCharacter
+         *     This is the character to put in front of every character
+         *     to escape.
+         *
+         * @param[in] charactersToEscape
+         *     These are the characters to escape.  Duplicates are ignored.
+         */
+        EscapeSpec(char escapeCharacter, std::string_view charactersToEscape);
+
+        // Public methods
+    public:
+        /**
+         * This method returns the character put in front of every
+         * character to escape.
+         *
+         * @return
+         *     The escape character is returned.
+         */
+        char GetEscapeCharacter() const {
+            return escapeCharacter;
+        }
+
+        /**
+         * This method returns the distinct characters to escape.
+         *
+         * @return
+         *     The distinct characters to escape are returned.
+         */
+        std::string_view GetCharacters() const {
+            return characters;
+        }
+
+        /**
+         * This method determines whether or not the given character
+         * is one to escape.
+         *
+         * @param[in] c
+         *     This is the character to check.
+         *
+         * @return
+         *     An indication of whether or not the given character
+         *     is one to escape is returned.
+         */
+        bool IsEscaped(char c) const {
+            const auto index = (unsigned char)c;
+            return ((members[index / 64] >> (index % 64)) & 1) != 0;
+        }
+
+        // Private properties
+    private:
+        /**
+         * This is the character put in front of every character to escape.
+         */
+        char escapeCharacter;
+
+        /**
+         * This is the bitmap of characters to escape, where bit N of the
+         * whole is set if the character with code N is to be escaped.
+         */
+        uint64_t members[4] = {0, 0, 0, 0};
+
+        /**
+         * These are the distinct characters to escape.
+         */
+        std::string characters;
+    };
+
+    /**
+     * This function return a copie of the given input string, modifird
+     * so that every character in the given "charactersToEscape" that is
+     * found in the input string is prefixed by the given "escapeCharacter".
+     *
+     * @param[in] s
+     *     This is the input string.
+     *
+     * @param[in] escapeCharacter
+     *     This is the character to put in front of every character
+     *     in the input string that is a member of the
+     *     "charactersToEscape" set.
+     *
+     * @param[in] charactersToEscape
+     *     These are the characters that should be escaped in the input.
+     *
+     * @return
+     *     A copy of the input string is returned, where every character
+     *     in the given "charactersToEscape" that is found in the input
+     *     string is prefixed by the given "escapeCharacter".
+     */
+    std::string Escape(const std::string& s, char escapeCharacter,
+                       const std::set<char>& charactersToEscape);
+
+    /**
+     * This function is the same as Escape, except that the escaped copy
+     * is allocated from the given memory resource.
+     *
+     * @param[in] s
+     *     This is the input string.
+     *
+     * @param[in] escapeCharacter
+     *     This is the character to put in front of every character
+     *     in the input string that is a member of the
+     *     "charactersToEscape" set.
+     *
+     * @param[in] charactersToEscape
+     *     These are the characters that should be escaped in the input.
+     *
+     * @param[in] resource
+     *     This is the memory resource from which to allocate the result.
+     *
+     * @return
+     *     The escaped copy of the input string is returned.
+     */
+    std::pmr::string Escape(std::string_view s, char escapeCharacter,
+                            const std::set<char>& charactersToEscape,
+                            std::pmr::memory_resource* resource);
+
+    /**
+     * This function is the same as Escape, except that the characters
+     * to escape, and how to escape them, are given by a specification
+     * prepared ahead of time.  The length of the escaped copy is worked
+     * out first, so that it's allocated only once.
+     *
+     * @param[in] s
+     *     This is the input string.
+     *
+     * @param[in] spec
+     *     This specifies which characters to escape, and how.
+     *
+     * @return
+     *     The escaped copy of the input string is returned.
+     */
+    std::string Escape(std::string_view s, const EscapeSpec& spec);
+
+    /**
+     * This function is the same as Escape, except that the escaped copy
+     * is allocated from the given memory resource.
+     *
+     * @param[in] s
+     *     This is the input string.
+     *
+     * @param[in] spec
+     *     This specifies which characters to escape, and how.
+     *
+     * @param[in] resource
+     *     This is the memory resource from which to allocate the result.
+     *
+     * @return
+     *     The escaped copy of the input string is returned.
+     */
+    std::pmr::string Escape(std::string_view s, const EscapeSpec& spec,
+                            std::pmr::memory_resource* resource);
+
+    /**
+     * This function removes the given escapeCharacter from the given input
+     * string.
+     *
+     * @param[in] s
+     *      This is the string from which to remove all escape characters.
+     *
+     * @param[in] escapCharacter
+     *      This is the character to remove from the given input string.
+     * @return
+     *      returns the given input string after removong all instances of
+     *      the given escapeCharacter.
+     */
+    std::string Unescape(const std::string& s, char escapeCharacter);
+
+    /**
+     * This function is the same as Unescape, except that the unescaped
+     * copy is allocated from the given memory resource.
+     *
+     * @param[in] s
+     *      This is the string from which to remove all escape characters.
+     *
+     * @param[in] escapCharacter
+     *      This is the character to remove from the given input string.
+     *
+     * @param[in] resource
+     *      This is the memory resource from which to allocate the result.
+     *
+     * @return
+     *      returns the given input string after removong all instances of
+     *      the given escapeCharacter.
+     */
+    std::pmr::string Unescape(std::string_view s, char escapeCharacter,
+                              std::pmr::memory_resource* resource);
+
+    /**
+     * This function is the same as Unescape, except that the given
+     * string is modified in place, rather than copied, since removing
+     * escape characters can only make it shorter.
+     *
+     * @param[in,out] s
+     *      This is the string from which to remove all escape characters.
+     *
+     * @param[in] escapeCharacter
+     *      This is the character to remove from the given string.
+     */
+    void UnescapeInPlace(std::string& s, char escapeCharacter);
+
+    /**
+     * This function break the given string at each instance of the
+     * given delimiter, returning the pieces as a collection of
+     * substrings. Tha delimiter charachters are removed.
+     *
+     * @param[in] s
+     *       This is the string to split.
+     * @param[in] d
+     *       This is the delimiter character at which to split the string.
+     * @return
+     *       returns the collection of substrings that result from breaking
+     *       the given string at each delimiter character.
+     */
+    std::vector<std::string> Split(const std::string& s, char d);
+
+    /**
+     * This function break the given string at each instance of the
+     * given delimiter, returning the pieces as a collection of
+     * substrings. Tha delimiter charachters are removed.
+     *
+     * @param[in] s
+     *       This is the string to split.
+     * @param[in] d
+     *       This is the delimiter string at which to split the string.
+     * @return
+     *       returns the collection of substrings that result from breaking
+     *       the given string at each delimiter string.
+     */
+    std::vector<std::string> Split(const std::string& s, const std::string& d);
+
+    /**
+     * This function is the same as Split, except that the pieces are
+     * returned as views into the given string rather than copies.
+     * The string is scanned once, and no memory is allocated other
+     * than for the returned collection.
+     *
+     * @param[in] s
+     *       This is the string to split.
+     * @param[in] d
+     *       This is the delimiter character at which to split the string.
+     * @return
+     *       returns the collection of views of the pieces that result from
+     *       breaking the given string at each delimiter character.
+     */
+    std::vector<std::string_view> SplitView(std::string_view s, char d);
+
+    /**
+     * This function is the same as Split, except that the pieces are
+     * returned as views into the given string rather than copies.
+     * The string is scanned once, and no memory is allocated other
+     * than for the returned collection.
+     *
+     * @param[in] s
+     *       This is the string to split.
+     * @param[in] d
+     *       This is the delimiter string at which to split the string.
+     * @return
+     *       returns the collection of views of the pieces that result from
+     *       breaking the given string at each delimiter string.
+     */
+    std::vector<std::string_view> SplitView(std::string_view s, std::string_view d);
+
+    /**
+     * This function is the same as Split, except that the collection
+     * of pieces, and the pieces themselves, are allocated from the given
+     * memory resource.
+     *
+     * @param[in] s
+     *       This is the string to split.
+     * @param[in] d
+     *       This is the delimiter character at which to split the string.
+     * @param[in] resource
+     *       This is the memory resource from which to allocate the result.
+     * @return
+     *       returns the collection of substrings that result from breaking
+     *       the given string at each delimiter character.
+     */
+    std::pmr::vector<std::pmr::string> Split(std::string_view s, char d,
+                                             std::pmr::memory_resource* resource);
+
+    /**
+     * This function is the same as Split, except that the collection
+     * of pieces, and the pieces themselves, are allocated from the given
+     * memory resource.
+     *
+     * @param[in] s
+     *       This is the string to split.
+     * @param[in] d
+     *       This is the delimiter string at which to split the string.
+     * @param[in] resource
+     *       This is the memory resource from which to allocate the result.
+     * @return
+     *       returns the collection of substrings that result from breaking
+     *       the given string at each delimiter string.
+     */
+    std::pmr::vector<std::pmr::string> Split(std::string_view s, std::string_view d,
+                                             std::pmr::memory_resource* resource);
+
+    /**
+     * This class is a lazy version of Split.  It is an input range
+     * whose elements are views of the pieces that result from breaking
+     * a string at each instance of a delimiter, trimmed the same way
+     * Split trims them.  Copies of an iterator may still be advanced
+     * independently, and the range may be iterated more than once.
+     *
+     * Pieces are found one at a time, as the range is iterated, so
+     * iteration may stop early without scanning the rest of the string.
+     * No memory is allocated, and the string must outlive the range
+     * and any of its iterators.
+     */
+    class SplitRange
+    {
+        // Types
+    public:
+        /**
+         * This is the type of iterator used to walk the pieces
+         * of the range.
+         */
+        class Iterator
+        {
+            // Types
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const std::string_view*;
+
+            /**
+             * Pieces are returned by value, rather than as references to
+             * the piece held by the iterator, so that they remain valid
+             * after the iterator moves on or is destroyed.  This is why
+             * the iterator is only an input iterator, since forward
+             * iterators must return references.
+             */
+            using reference = std::string_view;
+
+            // Lifecycle management
+        public:
+            /**
+             * This constructs an iterator which is equal to the end
+             * iterator of any range.
+             */
+            Iterator() = default;
+
+            // Operators
+        public:
+            reference operator*() const {
+                return piece;
+            }
+
+            pointer operator->() const {
+                return &piece;
+            }
+
+            Iterator& operator++();
+            Iterator operator++(int);
+            bool operator==(const Iterator& other) const;
+            bool operator!=(const Iterator& other) const;
+
+            // Private methods
+        private:
+            friend class SplitRange;
+
+            /**
+             * This constructs an iterator positioned at the first piece
+             * of the given string.
+             *
+             * @param[in] s
+             *      This is the string to split.
+             *
+             * @param[in] delimiter
+             *      This is the delimiter string, used if "delimiterIsCharacter"
+             *      is false.
+             *
+             * @param[in] delimiterCharacter
+             *      This is the delimiter character, used if
+             *      "delimiterIsCharacter" is true.
+             *
+             * @param[in] delimiterIsCharacter
+             *      This indicates whether the delimiter is a single character.
+             */
+            Iterator(std::string_view s, std::string_view delimiter, char delimiterCharacter,
+                     bool delimiterIsCharacter);
+
+            /**
+             * This method finds the next piece of the string, or marks
+             * the iterator as being at the end if there are no more pieces.
+             */
+            void Advance();
+
+            // Properties
+        private:
+            /**
+             * This is the piece at which the iterator is positioned.
+             */
+            std::string_view piece;
+
+            /**
+             * This is the part of the string that follows the current
+             * piece and its delimiter.
+             */
+            std::string_view rest;
+
+            /**
+             * This is the delimiter string, used if "delimiterIsCharacter"
+             * is false.
+             */
+            std::string_view delimiter;
+
+            /**
+             * This is the delimiter character, used if
+             * "delimiterIsCharacter" is true.
+             */
+            char delimiterCharacter = 0;
+
+            /**
+             * This indicates whether the delimiter is a single character.
+             */
+            bool delimiterIsCharacter = false;
+
+            /**
+             * This indicates whether the iterator has moved past
+             * the last piece.
+             */
+            bool done = true;
+        };
+
+        using iterator = Iterator;
+        using const_iterator = Iterator;
+
+        // Lifecycle management
+    public:
+        /**
+         * This constructs a range of the pieces that result from
+         * breaking the given string at each instance of the given
+         * delimiter character.
+         *
+         * @param[in] s
+         *      This is the string to split.
+         *
+         * @param[in] d
+         *      This is the delimiter character at which to split the string.
+         */
+        SplitRange(std::string_view s, char d);
+
+        /**
+         * This constructs a range of the pieces that result from
+         * breaking the given string at each instance of the given
+         * delimiter string.
+         *
+         * @param[in] s
+         *      This is the string to split.
+         *
+         * @param[in] d
+         *      This is the delimiter string at which to split the string.
+         *      It must outlive the range and any of its iterators.
+         */
+        SplitRange(std::string_view s, std::string_view d);
+
+        // Public methods
+    public:
+        /**
+         * This method returns an iterator positioned at the first piece.
+         *
+         * @return
+         *      An iterator positioned at the first piece is returned.
+         */
+        Iterator begin() const;
+
+        /**
+         * This method returns an iterator positioned past the last piece.
+         *
+         * @return
+         *      An iterator positioned past the last piece is returned.
+         */
+        Iterator end() const;
+
+        // Properties
+    private:
+        /**
+         * This is the string to split.
+         */
+        std::string_view s;
+
+        /**
+         * This is the delimiter string, used if "delimiterIsCharacter"
+         * is false.
+         */
+        std::string_view delimiter;
+
+        /**
+         * This is the delimiter character, used if
+         * "delimiterIsCharacter" is true.
+         */
+        char delimiterCharacter = 0;
+
+        /**
+         * This indicates whether the delimiter is a single character.
+         */
+        bool delimiterIsCharacter = false;
+    };
+
+    /**
+     * This class is an incremental version of Split, for strings which
+     * arrive a chunk at a time, such as from a network connection.
+     * Each piece is handed to a delegate as soon as it's complete, and
+     * the pieces are the same as Split would return for the whole string,
+     * even where a delimiter straddles two chunks.
+     *
+     * Only the unfinished piece at the end of each chunk is kept, so
+     * memory use is bounded by the longest piece rather than the string.
+     * A piece ended by a delimiter which ends with whitespace, such as
+     * ", ", is only handed over once something other than whitespace
+     * follows the delimiter, since Split ignores such a delimiter at the
+     * very end of the string.
+     */
+    class StreamSplitter
+    {
+        // Types
+    public:
+        /**
+         * This is the type of function called with each piece.
+         * The piece is only valid during the call.
+         */
+        using TokenDelegate = std::function<void(std::string_view token)>;
+
+        // Public methods
+    public:
+        /**
+         * This constructs the splitter.
+         *
+         * @param[in] d
+         *     This is the delimiter character at which to split the string.
+         *
+         * @param[in] tokenDelegate
+         *     This is the function to call with each piece.
+         */
+        StreamSplitter(char d, TokenDelegate tokenDelegate);
+
+        /**
+         * This constructs the splitter.
+         *
+         * @param[in] d
+         *     This is the delimiter string at which to split the string.
+         *
+         * @param[in] tokenDelegate
+         *     This is the function to call with each piece.
+         */
+        StreamSplitter(std::string_view d, TokenDelegate tokenDelegate);
+
+        /**
+         * This method splits the next chunk of the string, handing every
+         * piece it completes to the delegate.
+         *
+         * @param[in] chunk
+         *     This is the next chunk of the string.
+         */
+        void Feed(std::string_view chunk);
+
+        /**
+         * This method signals the end of the string, handing the last
+         * piece, if any, to the delegate.  The splitter may then be fed
+         * another string.
+         */
+        void Finish();
+
+        /**
+         * This method returns the number of characters kept from the
+         * chunks fed so far, for the piece not yet complete.
+         *
+         * @return
+         *     The number of characters kept is returned.
+         */
+        size_t GetPendingLength() const;
+
+        // Private methods
+    private:
+        /**
+         * This method splits the given characters, which begin between
+         * pieces, keeping the unfinished piece at the end.
+         *
+         * @param[in] rest
+         *     These are the characters to split.
+         */
+        void Scan(std::string_view rest);
+
+        /**
+         * This method handles a delimiter found after the given piece,
+         * followed by the given characters.  A delimiter ending with
+         * whitespace, but not made up only of whitespace, only counts if
+         * something other than whitespace follows it, since Split trims
+         * the string before looking for delimiters.
+         *
+         * @param[in] piece
+         *     These are the characters before the delimiter.
+         *
+         * @param[in] after
+         *     These are the characters after the delimiter.
+         *
+         * @return
+         *     An indication of whether or not the delimiter counts
+         *     is returned.  If it isn't known yet, the piece and the
+         *     delimiter are kept until it is.
+         */
+        bool EndPiece(std::string_view piece, std::string_view after);
+
+        // Private properties
+    private:
+        /**
+         * This is the delimiter at which to split the string.
+         */
+        std::string delimiter;
+
+        /**
+         * This is the function to call with each piece.
+         */
+        TokenDelegate tokenDelegate;
+
+        /**
+         * These are the characters of the unfinished piece, without
+         * any whitespace at the front.
+         */
+        std::string pending;
+
+        /**
+         * This indicates whether or not the pending characters end with
+         * a delimiter which only counts if something other than
+         * whitespace follows it.
+         */
+        bool pendingDelimiter = false;
+    };
+
+    /**
+     * This class finds instances of any of a set of patterns in strings.
+     * The patterns are compiled once, when the matcher is constructed,
+     * into an automaton (Aho-Corasick) which then finds instances of all
+     * of them in a single scan, regardless of how many patterns there are.
+     *
+     * Where instances overlap, the one which starts first is chosen,
+     * and of those, the longest.
+     */
+    class PatternMatcher
+    {
+        // Types
+    public:
+        /**
+         * This describes an instance of a pattern found in a string.
+         */
+        struct Match
+        {
+            /**
+             * This is the position in the string where the instance begins.
+             */
+            size_t position = 0;
+
+            /**
+             * This is the number of characters in the instance.
+             */
+            size_t length = 0;
+
+            /**
+             * This is the index of the matching pattern, in the order
+             * in which the patterns were given to the matcher.
+             */
+            size_t pattern = 0;
+        };
+
+        // Lifecycle management
+    public:
+        ~PatternMatcher() noexcept;
+        PatternMatcher(const PatternMatcher&) = delete;
+        PatternMatcher(PatternMatcher&&) noexcept;
+        PatternMatcher& operator=(const PatternMatcher&) = delete;
+        PatternMatcher& operator=(PatternMatcher&&) noexcept;
+
+        // Public methods
+    public:
+        /**
+         * This constructs the matcher, compiling the given patterns.
+         * Empty patterns never match.
+         *
+         * @param[in] patterns
+         *      These are the patterns to find.
+         */
+        explicit PatternMatcher(const std::vector<std::string>& patterns);
+
+        /**
+         * This method returns the patterns which the matcher finds.
+         *
+         * @return
+         *      The patterns which the matcher finds are returned.
+         */
+        const std::vector<std::string>& GetPatterns() const;
+
+        /**
+         * This method finds the first instance of any of the patterns
+         * in the given string, at or after the given position.
+         *
+         * @param[in] s
+         *      This is the string to search.
+         *
+         * @param[in] position
+         *      This is the position in the string at which to begin searching.
+         *
+         * @param[out] match
+         *      This is where to store the location of the instance found.
+         *
+         * @return
+         *      An indication of whether or not an instance was found
+         *      is returned.
+         */
+        bool FindNext(std::string_view s, size_t position, Match& match) const;
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance. It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr<Impl> impl_;
+    };
+
+    /**
+     * This function breaks the given string at each instance of any of
+     * the patterns of the given matcher, returning the pieces as a
+     * collection of substrings, trimmed the same way Split trims them.
+     * The delimiters are removed.
+     *
+     * @param[in] s
+     *       This is the string to split.
+     * @param[in] delimiters
+     *       This finds the delimiter strings at which to split the string.
+     * @return
+     *       returns the collection of substrings that result from breaking
+     *       the given string at each delimiter string.
+     */
+    std::vector<std::string> SplitAny(const std::string& s, const PatternMatcher& delimiters);
+
+    /**
+     * This function breaks the given string at each instance of any of
+     * the given delimiter strings, returning the pieces as a collection
+     * of substrings, trimmed the same way Split trims them.
+     * The delimiters are removed.
+     *
+     * @param[in] s
+     *       This is the string to split.
+     * @param[in] delimiters
+     *       These are the delimiter strings at which to split the string.
+     * @return
+     *       returns the collection of substrings that result from breaking
+     *       the given string at each delimiter string.
+     */
+    std::vector<std::string> SplitAny(const std::string& s,
+                                      const std::vector<std::string>& delimiters);
+
+    /**
+     * This function returns a copy of the given string, in which every
+     * instance of any of the patterns of the given matcher is replaced
+     * by the corresponding replacement.  The string is scanned once.
+     *
+     * @param[in] s
+     *      This is the string in which to replace patterns.
+     *
+     * @param[in] patterns
+     *      This finds the patterns to replace.
+     *
+     * @param[in] replacements
+     *      These are the replacements for the patterns, in the same
+     *      order as the patterns were given to the matcher.  Any pattern
+     *      without a replacement, because there are fewer replacements
+     *      than patterns, is removed from the string wherever it's found.
+     *
+     * @return
+     *      The string with all patterns replaced is returned.
+     */
+    std::string ReplaceAll(const std::string& s, const PatternMatcher& patterns,
+                           const std::vector<std::string>& replacements);
+
+    /**
+     * This function returns a copy of the given string, in which every
+     * instance of any of the keys of the given collection is replaced
+     * by the corresponding value.  The string is scanned once.
+     *
+     * @param[in] s
+     *      This is the string in which to replace patterns.
+     *
+     * @param[in] replacements
+     *      This maps the patterns to replace to their replacements.
+     *
+     * @return
+     *      The string with all patterns replaced is returned.
+     */
+    std::string ReplaceAll(const std::string& s,
+                           const std::map<std::string, std::string>& replacements);
+
+    /**
+     * This function take the given sequence of substrings to
+     * concatenate them together into a formel string, each piece separated by
+     * the given delimiter character.
+     *
+     * @param[in] v
+     *        This is the sequence of substrings to join together.
+     *
+     * @param[in] d
+     *        This is the delimiter character used as glue between
+     *        substrings.
+     * @return
+     *        returns a string formed formed from the concatenation
+     *        of the sequece of substrings separeted by the given
+     *        delimiter character.
+     */
+    std::string Join(const std::vector<std::string>& v, const char d);
+
+    /**
+     * This function take the given sequence of substrings to
+     * concatenate them together into a formel string, each piece separated by
+     * the given delimiter character.
+     *
+     * @param[in] v
+     *        This is the sequence of substrings to join together.
+     *
+     * @param[in] d
+     *        This is the delimiter character used as glue between
+     *        substrings.
+     * @return
+     *        returns a string formed formed from the concatenation
+     *        of the sequece of substrings separeted by the given
+     *        delimiter character.
+     */
+    std::string Join(const std::vector<std::string>& v, const std::string& d);
+
+    /**
+     * This function is the same as Join, except that the joined string
+     * is allocated from the given memory resource.
+     *
+     * @param[in] v
+     *        This is the sequence of substrings to join together.
+     *
+     * @param[in] d
+     *        This is the delimiter character used as glue between
+     *        substrings.
+     *
+     * @param[in] resource
+     *        This is the memory resource from which to allocate the result.
+     * @return
+     *        returns a string formed formed from the concatenation
+     *        of the sequece of substrings separeted by the given
+     *        delimiter character.
+     */
+    std::pmr::string Join(const std::pmr::vector<std::pmr::string>& v, char d,
+                          std::pmr::memory_resource* resource);
+
+    /**
+     * This function is the same as Join, except that the joined string
+     * is allocated from the given memory resource.
+     *
+     * @param[in] v
+     *        This is the sequence of substrings to join together.
+     *
+     * @param[in] d
+     *        This is the delimiter string used as glue between
+     *        substrings.
+     *
+     * @param[in] resource
+     *        This is the memory resource from which to allocate the result.
+     * @return
+     *        returns a string formed formed from the concatenation
+     *        of the sequece of substrings separeted by the given
+     *        delimiter string.
+     */
+    std::pmr::string Join(const std::pmr::vector<std::pmr::string>& v, std::string_view d,
+                          std::pmr::memory_resource* resource);
+
+    /**
+     * This function is the same as Split, except that the string is
+     * broken into chunks at delimiters, which are split at the same time
+     * by different threads.  The pieces are the same, in the same order,
+     * as those returned by Split.  Strings too short to be worth sharing
+     * between threads are split by the calling thread alone.
+     *
+     * @param[in] s
+     *       This is the string to split.
+     *
+     * @param[in] d
+     *       This is the delimiter character at which to split the string.
+     *
+     * @param[in] threads
+     *       This is the most threads to use, or zero to use one thread
+     *       per processor core.
+     *
+     * @return
+     *       The collection of substrings that result from breaking
+     *       the given string at each delimiter character is returned.
+     */
+    std::vector<std::string> ParallelSplit(std::string_view s, char d, size_t threads = 0);
+
+    /**
+     * This function is the same as ParallelSplit, except that the pieces
+     * are returned as views into the given string rather than copies.
+     *
+     * @param[in] s
+     *       This is the string to split.
+     *
+     * @param[in] d
+     *       This is the delimiter character at which to split the string.
+     *
+     * @param[in] threads
+     *       This is the most threads to use, or zero to use one thread
+     *       per processor core.
+     *
+     * @return
+     *       Views of the pieces of the given string are returned.
+     */
+    std::vector<std::string_view> ParallelSplitView(std::string_view s, char d,
+                                                    size_t threads = 0);
+
+    /**
+     * This function is the same as Join, except that the pieces are
+     * copied into the joined string by different threads at the same
+     * time.  Where each piece goes is worked out beforehand, so the
+     * joined string is allocated only once.  Short strings are joined
+     * by the calling thread alone.
+     *
+     * @param[in] v
+     *        This is the sequence of substrings to join together.
+     *
+     * @param[in] d
+     *        This is the delimiter string used as glue between
+     *        substrings.
+     *
+     * @param[in] threads
+     *       This is the most threads to use, or zero to use one thread
+     *       per processor core.
+     *
+     * @return
+     *        The concatenation of the substrings, separated by the
+     *        delimiter, is returned.
+     */
+    std::string ParallelJoin(const std::vector<std::string>& v, std::string_view d,
+                             size_t threads = 0);
+
+    /**
+     * This function check each character of the given string
+     * to convert them to lower-case.
+     *
+     * @param[in] s
+     *      This is the string to check and to convert to lower-case.
+     * @return
+     *      Returns the given string in lower-case style
+     */
+    std::string Tolower(const std::string& s);
+
+    /**
+     * This function is the same as Tolower, except that the converted
+     * string is allocated from the given memory resource.
+     *
+     * @param[in] s
+     *      This is the string to check and to convert to lower-case.
+     * @param[in] resource
+     *      This is the memory resource from which to allocate the result.
+     * @return
+     *      Returns the given string in lower-case style
+     */
+    std::pmr::string Tolower(std::string_view s, std::pmr::memory_resource* resource);
+
+    /**
+     * This function converts all upper-case characters of the given
+     * string to lower-case, in place, without allocating any memory.
+     *
+     * @param[in,out] s
+     *      This is the string to convert to lower-case.
+     */
+    void TolowerInPlace(std::string& s);
+
+    /**
+     * This function stores a copy of the given string, with all
+     * upper-case characters converted to lower-case, in the given
+     * buffer, without allocating any memory.
+     *
+     * @param[in] s
+     *      This is the string to convert to lower-case.
+     * @param[out] output
+     *      This is where to store the converted string.  It must have room
+     *      for as many characters as the given string has, and may point
+     *      to the given string itself.
+     */
+    void TolowerInto(std::string_view s, char* output);
+
+    /**
+     * This function parses the given string as an
+     * integer, detecting invalid characters, overflow, etc.
+     *
+     * @param[in] numberString
+     *     This is the string containing the number to parse.
+     *
+     * @param[out] number
+     *     This is where to store the number parsed.
+     *
+     * @return
+     *     An indication of whether or not the number was parsed
+     *     successfully is returned.
+     */
+    ToIntegerResult ToInteger(const std::string& numberString, intmax_t& number);
+
+    /**
+     * This function parses the given string as an integer of the
+     * given type, in the given base, detecting invalid characters,
+     * overflow, etc.  The rules are the same as for the other ToInteger:
+     * an optional leading minus sign (only for signed types) followed by
+     * digits, with no superfluous leading zeros.  Letters, in either case,
+     * are digits with values from 10 upwards, for bases above 10.
+     *
+     * This is available for all standard integer and character types
+     * of up to 64 bits, other than bool.
+     *
+     * @param[in] numberString
+     *     This is the string containing the number to parse.
+     *
+     * @param[out] number
+     *     This is where to store the number parsed.
+     *
+     * @param[in] base
+     *     This is the base of the number, from 2 to 36.
+     *
+     * @return
+     *     An indication of whether or not the number was parsed
+     *     successfully is returned.
+     */
+    template <typename Integer>
+    ToIntegerResult ToInteger(std::string_view numberString, Integer& number, int base = 10);
+
+    /**
+     * This function is the same as ToInteger, except that the number
+     * need only occupy the beginning of the given string, so that it can
+     * be used to pick numbers out of larger text.  Parsing stops at the
+     * first character which is not a digit.
+     *
+     * @param[in] numberString
+     *     This is the string beginning with the number to parse.
      *
      * @param[out] number
      *     This is where to store the number parsed.
      *
+     * @param[out] consumed
+     *     This is where to store the number of characters which make up
+     *     the number.  On overflow, this includes all the digits.
+     *
+     * @param[in] base
+     *     This is the base of the number, from 2 to 36.
+     *
      * @return
      *     An indication of whether or not the number was parsed
      *     successfully is returned.
      */
-    ToIntegerResult ToInteger(const std::string& numberString, intmax_t& number);
+    template <typename Integer>
+    ToIntegerResult ToIntegerPrefix(std::string_view numberString, Integer& number,
+                                    size_t& consumed, int base = 10);
+
+    /**
+     * This function parses the given string as a double-precision
+     * floating-point number, rounded to the nearest representable value.
+     * The number is an optional leading minus sign, digits with an
+     * optional decimal point, and an optional exponent ("e" or "E"
+     * followed by an optionally signed integer).  The current locale
+     * has no effect, and the string need not be null-terminated.
+     *
+     * This grammar is looser than the one ToInteger uses, to accept
+     * numbers as other programs commonly write them: leading zeros are
+     * allowed ("007"), and the decimal point may come before or after
+     * all the digits (".5" or "1."), as long as there is at least one
+     * digit.  A leading plus sign, whitespace, and words such as "inf"
+     * or "nan" are not accepted.
+     *
+     * @param[in] numberString
+     *     This is the string containing the number to parse.
+     *
+     * @param[out] number
+     *     This is where to store the number parsed.
+     *
+     * @return
+     *     An indication of whether or not the number was parsed
+     *     successfully is returned.
+     */
+    ToDoubleResult ToDouble(std::string_view numberString, double& number);
+
+    /**
+     * This function is the same as ToDouble, except that it parses
+     * the number as a single-precision floating-point number.
+     *
+     * @param[in] numberString
+     *     This is the string containing the number to parse.
+     *
+     * @param[out] number
+     *     This is where to store the number parsed.
+     *
+     * @return
+     *     An indication of whether or not the number was parsed
+     *     successfully is returned.
+     */
+    ToDoubleResult ToFloat(std::string_view numberString, float& number);
+
+    /**
+     * These are the kinds of problems ParseColumns can find with
+     * individual fields.
+     */
+    enum class FieldErrorKind
+    {
+        /**
+         * This indicates the field was empty or was not a number.
+         */
+        NotANumber,
+
+        /**
+         * This indicates the field was too large in magnitude
+         * for the type of the column.
+         */
+        Overflow,
+
+        /**
+         * This indicates the field was too small in magnitude
+         * for the type of the column, but was not zero.
+         */
+        Underflow,
+
+        /**
+         * This indicates the record ended before the field.
+         */
+        Missing,
+
+        /**
+         * This indicates the record had more fields than there are columns.
+         */
+        Unexpected
+    };
+
+    /**
+     * This describes one field ParseColumns could not parse.
+     */
+    struct FieldError
+    {
+        /**
+         * This is the index of the record (among those parsed)
+         * containing the field.
+         */
+        size_t record = 0;
+
+        /**
+         * This is the index of the field within its record.
+         */
+        size_t field = 0;
+
+        /**
+         * This is the offset of the field in the buffer.  For missing
+         * fields, it's the offset of the end of the record.
+         */
+        size_t offset = 0;
+
+        /**
+         * This indicates what was wrong with the field.
+         */
+        FieldErrorKind kind = FieldErrorKind::NotANumber;
+    };
+
+    /**
+     * This function parses a buffer of delimited records of numbers,
+     * such as numeric CSV, straight into a caller-provided array, without
+     * making a string for any field.  Values are stored a record at a
+     * time, so that field F of record R goes to values[R * columns + F].
+     *
+     * Whitespace around fields is ignored, as are records which are
+     * empty or only whitespace.  The end of the buffer ends the last
+     * record.  Fields which can't be parsed are stored as zero and
+     * reported in the given errors vector, rather than stopping the parse.
+     *
+     * This is available for int64_t and double values.
+     *
+     * @param[in] buffer
+     *     This is the buffer of records to parse.
+     *
+     * @param[in] fieldDelimiter
+     *     This is the character which separates fields within a record.
+     *
+     * @param[in] recordDelimiter
+     *     This is the character which separates records.
+     *
+     * @param[in] columns
+     *     This is the number of fields in each record.
+     *
+     * @param[out] values
+     *     This is where to store the values parsed.  It must have room
+     *     for columns * maxRecords values.
+     *
+     * @param[in] maxRecords
+     *     This is the maximum number of records to parse.
+     *
+     * @param[out] errors
+     *     This is where to append descriptions of any fields
+     *     which could not be parsed.
+     *
+     * @param[out] consumed
+     *     This is where to store the number of characters of the buffer
+     *     which were parsed, so that parsing can pick up from there if
+     *     maxRecords was reached.
+     *
+     * @return
+     *     The number of records parsed is returned.
+     */
+    template <typename Number>
+    size_t ParseColumns(std::string_view buffer, char fieldDelimiter, char recordDelimiter,
+                        size_t columns, Number* values, size_t maxRecords,
+                        std::vector<FieldError>& errors, size_t& consumed);
+
+    /**
+     * This is the interface to an object which receives the output
+     * of instantiating a template, a piece at a time, in order.
+     */
+    class TemplateSink
+    {
+        // Lifecycle management
+    public:
+        virtual ~TemplateSink() noexcept = default;
+
+        // Methods
+    public:
+        /**
+         * This method receives the next piece of output.
+         *
+         * @param[in] piece
+         *     This is the next piece of output.  It points either into the
+         *     template or into the value of a variable, and so remains valid
+         *     only as long as they do.
+         */
+        virtual void Write(std::string_view piece) = 0;
+    };
+
+    /**
+     * This is a template sink which appends the output to a string.
+     */
+    class StringSink : public TemplateSink
+    {
+        // Public methods
+    public:
+        /**
+         * This constructs the sink.
+         *
+         * @param[in,out] output
+         *     This is the string to which to append the output.
+         */
+        explicit StringSink(std::string& output);
+
+        // TemplateSink
+    public:
+        void Write(std::string_view piece) override;
+
+        // Private properties
+    private:
+        /**
+         * This is the string to which to append the output.
+         */
+        std::string& output;
+    };
+
+    /**
+     * This is a template sink which collects, without copying, the
+     * location and length of each piece of output, so that they can
+     * be written out in one gather operation, such as "writev".
+     */
+    class IoVectorSink : public TemplateSink
+    {
+        // Types
+    public:
+        /**
+         * This locates one piece of output.  It has the same members,
+         * in the same order, as the POSIX "iovec" structure.
+         */
+        struct IoVector
+        {
+            /**
+             * This points to the first character of the piece.
+             */
+            void* base;
+
+            /**
+             * This is the number of characters in the piece.
+             */
+            size_t length;
+        };
+
+        // Public methods
+    public:
+        /**
+         * This method returns the pieces of output collected so far.
+         *
+         * @return
+         *     The pieces of output collected so far are returned.
+         */
+        const std::vector<IoVector>& GetPieces() const;
+
+        /**
+         * This method returns the total number of characters of output
+         * collected so far.
+         *
+         * @return
+         *     The total number of characters of output collected so far
+         *     is returned.
+         */
+        size_t GetLength() const;
+
+        /**
+         * This method forgets all pieces collected so far.
+         */
+        void Clear();
+
+        // TemplateSink
+    public:
+        void Write(std::string_view piece) override;
+
+        // Private properties
+    private:
+        /**
+         * These are the pieces of output collected so far.
+         */
+        std::vector<IoVector> pieces;
+
+        /**
+         * This is the total number of characters of output collected so far.
+         */
+        size_t length = 0;
+    };
+
+    /**
+     * This is a template sink which copies output into a buffer of
+     * fixed capacity, handing the buffer's contents to a delegate
+     * each time it fills, so that memory use stays bounded no matter
+     * how much output there is.
+     */
+    class ChunkedSink : public TemplateSink
+    {
+        // Types
+    public:
+        /**
+         * This is the type of function called to consume each chunk
+         * of output.  The chunk is only valid during the call.
+         */
+        using ChunkDelegate = std::function<void(std::string_view chunk)>;
+
+        // Public methods
+    public:
+        /**
+         * This constructs the sink.
+         *
+         * @param[in] capacity
+         *     This is the number of characters the buffer can hold.
+         *
+         * @param[in] chunkDelegate
+         *     This is the function to call to consume each chunk of output.
+         */
+        ChunkedSink(size_t capacity, ChunkDelegate chunkDelegate);
+
+        /**
+         * This method hands any output remaining in the buffer to the
+         * delegate.  It should be called once all output has been written.
+         */
+        void Flush();
+
+        // TemplateSink
+    public:
+        void Write(std::string_view piece) override;
+
+        // Private properties
+    private:
+        /**
+         * This holds output which has not yet been handed to the delegate.
+         */
+        std::vector<char> buffer;
+
+        /**
+         * This is the number of characters of output in the buffer.
+         */
+        size_t length = 0;
+
+        /**
+         * This is the function to call to consume each chunk of output.
+         */
+        ChunkDelegate chunkDelegate;
+    };
 
     /**
      * Take the given template and produce a string which is a copy of
@@ -279,6 +2399,188 @@ namespace StringUtils
     std::string InstantiateTemplate(const std::string& templateText,
                                     const std::map<std::string, std::string>& variables);
 
+    /**
+     * Take the given template and write a copy of it, with substitution
+     * markers replaced by the values of corresponding entries in the
+     * given collection of variables, to the given sink.  Nothing is
+     * copied; the pieces of output point into the template and the
+     * values of the variables.
+     *
+     * @param[in] templateText
+     *     This is the template to instantiate.
+     *
+     * @param[in] variables
+     *     This holds the values of variables which may be substituted
+     *     in the template.
+     *
+     * @param[in,out] sink
+     *     This is where to write the instantiated template.
+     */
+    void InstantiateTemplate(const std::string& templateText,
+                             const std::map<std::string, std::string>& variables,
+                             TemplateSink& sink);
+
+    /**
+     * This function is the same as InstantiateTemplate, except that the
+     * instantiated template is allocated from the given memory resource.
+     * Variables are looked up by std::string keys, so a variable name too
+     * long to fit in a short string may cause an allocation from the
+     * global heap, though only if it's longer than every name before it.
+     *
+     * @param[in] templateText
+     *     This is the template to instantiate.
+     *
+     * @param[in] variables
+     *     This holds the values of variables which may be substituted
+     *     in the template.
+     *
+     * @param[in] resource
+     *     This is the memory resource from which to allocate the result.
+     *
+     * @return
+     *     The instantiated template is returned.
+     */
+    std::pmr::string InstantiateTemplate(std::string_view templateText,
+                                         const std::map<std::string, std::string>& variables,
+                                         std::pmr::memory_resource* resource);
+
+    /**
+     * This class holds a template, in the form accepted by
+     * InstantiateTemplate, which has been parsed once into a sequence
+     * of literal text segments and variable slots, so that it can be
+     * instantiated many times without parsing it again.
+     */
+    class CompiledTemplate
+    {
+        // Lifecycle management
+    public:
+        ~CompiledTemplate() noexcept;
+        CompiledTemplate(const CompiledTemplate&) = delete;
+        CompiledTemplate(CompiledTemplate&&) noexcept;
+        CompiledTemplate& operator=(const CompiledTemplate&) = delete;
+        CompiledTemplate& operator=(CompiledTemplate&&) noexcept;
+
+        // Public methods
+    public:
+        /**
+         * This constructs the template by parsing the given template text.
+         *
+         * @param[in] templateText
+         *     This is the template to parse.
+         */
+        explicit CompiledTemplate(std::string_view templateText);
+
+        /**
+         * This method returns the names of the variables which may be
+         * substituted in the template, each listed once, in the order in
+         * which they first appear.  The index of a name in this list is
+         * the index of the variable's slot.
+         *
+         * @return
+         *     The names of the variables in the template are returned.
+         */
+        const std::vector<std::string>& GetVariableNames() const;
+
+        /**
+         * This method produces an instance of the template, with
+         * substitution markers replaced by the values of corresponding
+         * entries in the given collection of variables.
+         *
+         * @param[in] variables
+         *     This holds the values of variables which may be substituted
+         *     in the template.
+         *
+         * @return
+         *     The instantiated template is returned.
+         */
+        std::string Render(const std::map<std::string, std::string>& variables) const;
+
+        /**
+         * This method writes an instance of the template to the given
+         * sink.  Nothing is copied; the pieces of output point into the
+         * compiled template and the values of the variables.
+         *
+         * @param[in] variables
+         *     This holds the values of variables which may be substituted
+         *     in the template.
+         *
+         * @param[in,out] sink
+         *     This is where to write the instantiated template.
+         */
+        void Render(const std::map<std::string, std::string>& variables,
+                    TemplateSink& sink) const;
+
+        /**
+         * This method produces an instance of the template, with
+         * substitution markers replaced by the values of corresponding
+         * entries in the given collection of variables.
+         *
+         * @param[in] variables
+         *     This holds the values of variables which may be substituted
+         *     in the template.
+         *
+         * @return
+         *     The instantiated template is returned.
+         */
+        std::string Render(const std::unordered_map<std::string, std::string>& variables) const;
+
+        /**
+         * This method writes an instance of the template to the given
+         * sink.  Nothing is copied; the pieces of output point into the
+         * compiled template and the values of the variables.
+         *
+         * @param[in] variables
+         *     This holds the values of variables which may be substituted
+         *     in the template.
+         *
+         * @param[in,out] sink
+         *     This is where to write the instantiated template.
+         */
+        void Render(const std::unordered_map<std::string, std::string>& variables,
+                    TemplateSink& sink) const;
+
+        /**
+         * This method produces an instance of the template, with
+         * substitution markers replaced by the given values, bound to
+         * variables by slot index (see GetVariableNames).  Variables
+         * whose slot index has no value are replaced by nothing.
+         *
+         * @param[in] values
+         *     These are the values of the variables, in slot order.
+         *
+         * @return
+         *     The instantiated template is returned.
+         */
+        std::string Render(const std::vector<std::string_view>& values) const;
+
+        /**
+         * This method writes an instance of the template to the given
+         * sink.  Nothing is copied; the pieces of output point into the
+         * compiled template and the values of the variables.
+         *
+         * @param[in] values
+         *     These are the values of the variables, in slot order.
+         *
+         * @param[in,out] sink
+         *     This is where to write the instantiated template.
+         */
+        void Render(const std::vector<std::string_view>& values, TemplateSink& sink) const;
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance. It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr<Impl> impl_;
+    };
+
     /**
      * This fucntion takes a string chaine and convert all upper-case characters
      * with lower-case equivalents.
@@ -290,6 +2592,66 @@ namespace StringUtils
      */
     std::string NormalizeCaseInsensitiveString(const std::string& inputString);
 
+    /**
+     * This function compares two strings without regard to the case
+     * of ASCII letters.  Other characters must match exactly.
+     *
+     * @param[in] lhs
+     *      This is the first string to compare.
+     *
+     * @param[in] rhs
+     *      This is the second string to compare.
+     *
+     * @return
+     *      A negative number is returned if the first string orders before
+     *      the second, a positive number if it orders after the second,
+     *      and zero if the two are equal.
+     */
+    int CaseInsensitiveCompare(std::string_view lhs, std::string_view rhs);
+
+    /**
+     * This is a hash function for strings which ignores the case
+     * of ASCII letters, for use in unordered containers together with
+     * CaseInsensitiveEqual.  Hashing doesn't copy or fold the string.
+     *
+     * Unordered containers can't be searched by any type other than
+     * their key type before C++20, so looking up a string_view or
+     * literal in a container keyed by std::string still makes a
+     * std::string to search for.  To look up keys without making
+     * copies, key the container by std::string_view, keeping the keys
+     * alive elsewhere, or use std::map with CaseInsensitiveLess, which
+     * can be searched by any string type.
+     */
+    struct CaseInsensitiveHash
+    {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view s) const;
+    };
+
+    /**
+     * This compares strings for equality without regard to the case
+     * of ASCII letters, for use in unordered containers together with
+     * CaseInsensitiveHash.
+     */
+    struct CaseInsensitiveEqual
+    {
+        using is_transparent = void;
+
+        bool operator()(std::string_view lhs, std::string_view rhs) const;
+    };
+
+    /**
+     * This orders strings without regard to the case of ASCII letters,
+     * for use in ordered containers.
+     */
+    struct CaseInsensitiveLess
+    {
+        using is_transparent = void;
+
+        bool operator()(std::string_view lhs, std::string_view rhs) const;
+    };
+
     /**
      * This function takes a string chaine and remove margin whitespace.
      * 
@@ -299,6 +2661,48 @@ namespace StringUtils
      *      returns a string without margin or whitespaces.
      */
     std::string StripMarginWhitespace(const std::string& inputString);
+
+    /**
+     * This function removes all whitespace (as StripMarginWhitespace
+     * does) from the given string, in place, without allocating
+     * any memory.
+     *
+     * @param[in,out] s
+     *      This is the string from which to remove whitespace.
+     */
+    void StripMarginWhitespaceInPlace(std::string& s);
+
+    /**
+     * This function stores a copy of the given string, with all whitespace
+     * (as StripMarginWhitespace does) removed, in the given buffer, without
+     * allocating any memory.
+     *
+     * @param[in] s
+     *      This is the string from which to remove whitespace.
+     *
+     * @param[out] output
+     *      This is where to store the copy.  It must have room for as
+     *      many characters as the given string has, and may point to the
+     *      given string itself.
+     *
+     * @return
+     *      The number of characters stored is returned.
+     */
+    size_t StripMarginWhitespaceInto(std::string_view s, char* output);
 }  // namespace StringUtils
 
+/**
+ * This calls StringUtils::Format with the given format string literal
+ * and values, after checking at compile time that the format string
+ * has one placeholder for each value.
+ */
+#define STRING_UTILS_FORMAT(...)                                                     \
+    ((void)::StringUtils::CheckFormatArguments<                                      \
+         ::StringUtils::CountFormatPlaceholders(                                     \
+             STRING_UTILS_FORMAT_EXPAND(STRING_UTILS_FORMAT_FIRST(__VA_ARGS__, 0))), \
+         decltype(::StringUtils::ArgumentCount(__VA_ARGS__))::value - 1>(),          \
+     ::StringUtils::Format(__VA_ARGS__))
+#define STRING_UTILS_FORMAT_FIRST(first, ...) first
+#define STRING_UTILS_FORMAT_EXPAND(x) x
+
 #endif /*STRING_UTILS_HPP*/
\ No newline at end of file
@@ -0,0 +1,353 @@
+/**
+ * @file Instrumentation.cpp
+ *
+ * This module contains the implementation of the
+ * StringUtils::Instrumentation functions.
+ *
+ * © 2024 by Hatem Nabli
+ */
+
+#include "Probe.hpp"
+#include "Simd.hpp"
+
+#if defined(STRING_UTILS_INSTRUMENTATION)
+#    include <algorithm>
+#    include <atomic>
+#    include <mutex>
+#endif
+
+namespace
+{
+    using namespace StringUtils::Instrumentation;
+
+    /**
+     * This is the number of families of functions.
+     */
+    constexpr size_t FunctionCount = (size_t)Function::Count;
+
+    /**
+     * These are the names of the families of functions,
+     * in the order they are listed in Function.
+     */
+    const char* const functionNames[FunctionCount] = {
+        "Split",
+        "Join",
+        "Trim",
+        "Escape",
+        "Unescape",
+        "ParseComponent",
+        "ToInteger",
+        "InstantiateTemplate",
+        "Indent",
+        "Tolower",
+        "StripMarginWhitespace",
+        "sprintf",
+    };
+
+    /**
+     * This function returns a set of statistics for every family
+     * of functions, all zero.
+     */
+    std::vector<FunctionStatistics> EmptyStatistics() {
+        std::vector<FunctionStatistics> statistics(FunctionCount);
+        for (size_t i = 0; i < FunctionCount; ++i)
+        { statistics[i].function = (Function)i; }
+        return statistics;
+    }
+
+#if defined(STRING_UTILS_INSTRUMENTATION)
+    /**
+     * This is a counter which is only ever changed by one thread,
+     * but may be read by others.  Since there is only one writer,
+     * it's incremented without a locked read-modify-write.
+     */
+    class Counter
+    {
+        // Public methods
+    public:
+        void Add(uint64_t amount) {
+            value.store(value.load(std::memory_order_relaxed) + amount,
+                        std::memory_order_relaxed);
+        }
+
+        uint64_t Get() const {
+            return value.load(std::memory_order_relaxed);
+        }
+
+        // Private properties
+    private:
+        std::atomic<uint64_t> value{0};
+    };
+
+    /**
+     * This holds the counters kept by one thread for one family of functions.
+     */
+    struct FunctionCounters
+    {
+        Counter calls;
+        Counter inputBytes;
+        Counter outputBytes;
+        Counter allocations;
+        Counter latency[LatencyBuckets];
+    };
+
+    /**
+     * This function adds the given counters to the given statistics.
+     *
+     * @param[in] counters
+     *      These are the counters to add.
+     *
+     * @param[in,out] statistics
+     *      These are the statistics to which to add the counters.
+     */
+    void Accumulate(const FunctionCounters& counters, FunctionStatistics& statistics) {
+        statistics.calls += counters.calls.Get();
+        statistics.inputBytes += counters.inputBytes.Get();
+        statistics.outputBytes += counters.outputBytes.Get();
+        statistics.allocations += counters.allocations.Get();
+        for (size_t i = 0; i < LatencyBuckets; ++i)
+        { statistics.latency[i] += counters.latency[i].Get(); }
+    }
+
+    struct ThreadCounters;
+
+    /**
+     * This keeps track of the counters of every thread, so that
+     * they can be added up on demand.
+     */
+    struct Registry
+    {
+        /**
+         * This is used to synchronize access to the registry.
+         */
+        std::mutex mutex;
+
+        /**
+         * These are the counters of the threads which are running.
+         */
+        std::vector<ThreadCounters*> threads;
+
+        /**
+         * These are the statistics recorded by threads which have exited.
+         */
+        std::vector<FunctionStatistics> retired = EmptyStatistics();
+
+        /**
+         * These are the statistics as they were at the last reset,
+         * which are subtracted from the statistics reported.
+         */
+        std::vector<FunctionStatistics> baseline = EmptyStatistics();
+    };
+
+    /**
+     * This function returns the registry of thread counters.  It's never
+     * destroyed, so that threads may still exit after static destructors
+     * have run.
+     */
+    Registry& GetRegistry() {
+        static auto registry = new Registry();
+        return *registry;
+    }
+
+    /**
+     * This holds the counters kept by one thread, which it registers
+     * the first time it records a call.
+     *
+     * The counters have no constructor to run, so that counting an
+     * allocation never causes another one.
+     */
+    struct ThreadCounters
+    {
+        /**
+         * This is the number of allocations counted on the thread.
+         */
+        Counter allocations;
+
+        /**
+         * These are the counters for each family of functions.
+         */
+        FunctionCounters functions[FunctionCount];
+
+        /**
+         * This indicates whether or not the counters are in the registry.
+         */
+        bool registered = false;
+
+        void Register() {
+            auto& registry = GetRegistry();
+            std::lock_guard<decltype(registry.mutex)> lock(registry.mutex);
+            registry.threads.push_back(this);
+            registered = true;
+        }
+
+        ~ThreadCounters() noexcept {
+            if (!registered)
+            { return; }
+            auto& registry = GetRegistry();
+            std::lock_guard<decltype(registry.mutex)> lock(registry.mutex);
+            for (size_t i = 0; i < FunctionCount; ++i)
+            { Accumulate(functions[i], registry.retired[i]); }
+            registry.threads.erase(
+                std::find(registry.threads.begin(), registry.threads.end(), this)
+            );
+        }
+    };
+
+    /**
+     * This function returns the counters kept by the calling thread.
+     */
+    ThreadCounters& GetThreadCounters() {
+        thread_local ThreadCounters counters;
+        return counters;
+    }
+
+    /**
+     * This function adds up the statistics recorded by every thread,
+     * including those since the last reset.  The registry must be locked.
+     *
+     * @param[in] registry
+     *      This is the registry of thread counters.
+     *
+     * @return
+     *      The statistics are returned.
+     */
+    std::vector<FunctionStatistics> GetTotals(const Registry& registry) {
+        auto totals = registry.retired;
+        for (const auto threadCounters : registry.threads)
+        {
+            for (size_t i = 0; i < FunctionCount; ++i)
+            { Accumulate(threadCounters->functions[i], totals[i]); }
+        }
+        return totals;
+    }
+#endif /* STRING_UTILS_INSTRUMENTATION */
+
+    /**
+     * This function appends the given field of a JSON object to the
+     * given output, preceded by a comma if it isn't the first field.
+     *
+     * @param[in,out] output
+     *      This is the output to which to append the field.
+     *
+     * @param[in] name
+     *      This is the name of the field.
+     *
+     * @param[in] value
+     *      This is the value of the field, already in JSON format.
+     *
+     * @param[in] first
+     *      This indicates whether or not this is the first field.
+     */
+    void AppendJsonField(std::string& output, const char* name, const std::string& value,
+                         bool first = false) {
+        if (!first)
+        { output += ','; }
+        output += '"';
+        output += name;
+        output += "\":";
+        output += value;
+    }
+}  // namespace
+
+namespace StringUtils
+{
+    namespace Instrumentation
+    {
+        const char* GetFunctionName(Function function) {
+            if ((size_t)function >= FunctionCount)
+            { return ""; }
+            return functionNames[(size_t)function];
+        }
+
+#if defined(STRING_UTILS_INSTRUMENTATION)
+        std::vector<FunctionStatistics> GetStatistics() {
+            auto& registry = GetRegistry();
+            std::lock_guard<decltype(registry.mutex)> lock(registry.mutex);
+            auto statistics = GetTotals(registry);
+            for (size_t i = 0; i < FunctionCount; ++i)
+            {
+                const auto& baseline = registry.baseline[i];
+                statistics[i].calls -= baseline.calls;
+                statistics[i].inputBytes -= baseline.inputBytes;
+                statistics[i].outputBytes -= baseline.outputBytes;
+                statistics[i].allocations -= baseline.allocations;
+                for (size_t j = 0; j < LatencyBuckets; ++j)
+                { statistics[i].latency[j] -= baseline.latency[j]; }
+            }
+            return statistics;
+        }
+
+        void Reset() {
+            // Counters belong to the threads which change them, so instead
+            // of clearing them, the current totals are set aside and
+            // subtracted from later ones.
+            auto& registry = GetRegistry();
+            std::lock_guard<decltype(registry.mutex)> lock(registry.mutex);
+            registry.baseline = GetTotals(registry);
+        }
+
+        void CountAllocation() {
+            GetThreadCounters().allocations.Add(1);
+        }
+
+        uint64_t GetThreadAllocations() {
+            return GetThreadCounters().allocations.Get();
+        }
+
+        void Record(Function function, size_t inputBytes, size_t outputBytes,
+                    uint64_t allocations, uint64_t nanoseconds) {
+            auto& threadCounters = GetThreadCounters();
+            if (!threadCounters.registered)
+            { threadCounters.Register(); }
+            auto& counters = threadCounters.functions[(size_t)function];
+            counters.calls.Add(1);
+            counters.inputBytes.Add(inputBytes);
+            counters.outputBytes.Add(outputBytes);
+            counters.allocations.Add(allocations);
+            const auto bucket = ((nanoseconds == 0) ? 0 : Simd::HighestBit(nanoseconds));
+            counters.latency[std::min((size_t)bucket, LatencyBuckets - 1)].Add(1);
+        }
+#else
+        std::vector<FunctionStatistics> GetStatistics() {
+            return EmptyStatistics();
+        }
+
+        void Reset() {
+        }
+#endif /* STRING_UTILS_INSTRUMENTATION */
+
+        std::string Dump() {
+            // The output is built without calling any instrumented functions,
+            // so that dumping the statistics doesn't change them.
+            std::string output = "{\"functions\":[";
+            bool firstFunction = true;
+            for (const auto& statistics : GetStatistics())
+            {
+                if (!firstFunction)
+                { output += ','; }
+                firstFunction = false;
+                output += '{';
+                AppendJsonField(
+                    output, "name",
+                    std::string("\"") + GetFunctionName(statistics.function) + "\"", true
+                );
+                AppendJsonField(output, "calls", std::to_string(statistics.calls));
+                AppendJsonField(output, "inputBytes", std::to_string(statistics.inputBytes));
+                AppendJsonField(output, "outputBytes", std::to_string(statistics.outputBytes));
+                AppendJsonField(output, "allocations", std::to_string(statistics.allocations));
+                std::string latency = "[";
+                for (size_t i = 0; i < LatencyBuckets; ++i)
+                {
+                    if (i > 0)
+                    { latency += ','; }
+                    latency += std::to_string(statistics.latency[i]);
+                }
+                latency += ']';
+                AppendJsonField(output, "latency", latency);
+                output += '}';
+            }
+            output += "]}";
+            return output;
+        }
+    }  // namespace Instrumentation
+}  // namespace StringUtils
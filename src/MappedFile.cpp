@@ -0,0 +1,216 @@
+/**
+ * @file MappedFile.cpp
+ *
+ * This module contains the implementation of the StringUtils::MappedFile
+ * class and the SplitFile function.
+ *
+ * © 2024 by Hatem Nabli
+ */
+
+#include <StringUtils\MappedFile.hpp>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#    define WIN32_LEAN_AND_MEAN
+#    include <Windows.h>
+#else
+#    include <fcntl.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <unistd.h>
+#endif
+
+namespace StringUtils
+{
+    /**
+     * This contains the private properties of a MappedFile instance.
+     */
+    struct MappedFile::Impl
+    {
+        // Properties
+
+        /**
+         * This is where the file is mapped, or null if the file
+         * isn't open or is empty.
+         */
+        const char* address = nullptr;
+
+        /**
+         * This is the length of the file.
+         */
+        size_t length = 0;
+
+        /**
+         * This indicates whether or not the file is open.
+         */
+        bool isOpen = false;
+
+        // Methods
+
+        /**
+         * This method maps the file at the given path into memory.
+         * The file itself is closed again once it's mapped, since the
+         * mapping keeps the contents available.
+         *
+         * @param[in] path
+         *     This is the path of the file to map, in UTF-8.
+         *
+         * @return
+         *     An indication of whether or not the file was mapped
+         *     successfully is returned.
+         */
+        bool Map(const std::string& path) {
+#if defined(_WIN32)
+            std::wstring widePath;
+            size_t errorOffset;
+            if (Utf8ToWide(path, widePath, errorOffset) != UtfResult::Success)
+            { return false; }
+            const auto file = CreateFileW(
+                widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL
+            );
+            if (file == INVALID_HANDLE_VALUE)
+            { return false; }
+            LARGE_INTEGER size;
+            if (
+                !GetFileSizeEx(file, &size)
+                || ((unsigned long long)size.QuadPart > (unsigned long long)SIZE_MAX)
+            )
+            {
+                (void)CloseHandle(file);
+                return false;
+            }
+            length = (size_t)size.QuadPart;
+            if (length > 0)
+            {
+                const auto mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+                if (mapping != NULL)
+                {
+                    address = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                    (void)CloseHandle(mapping);
+                }
+                if (address == nullptr)
+                {
+                    (void)CloseHandle(file);
+                    return false;
+                }
+            }
+            (void)CloseHandle(file);
+#else
+            const auto file = open(path.c_str(), O_RDONLY);
+            if (file < 0)
+            { return false; }
+            struct stat status;
+            if (
+                (fstat(file, &status) != 0)
+                || ((unsigned long long)status.st_size > (unsigned long long)SIZE_MAX)
+            )
+            {
+                (void)close(file);
+                return false;
+            }
+            length = (size_t)status.st_size;
+            if (length > 0)
+            {
+                const auto mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, file, 0);
+                if (mapping == MAP_FAILED)
+                {
+                    (void)close(file);
+                    return false;
+                }
+                address = (const char*)mapping;
+                (void)madvise(mapping, length, MADV_SEQUENTIAL);
+            }
+            (void)close(file);
+#endif
+            isOpen = true;
+            return true;
+        }
+
+        /**
+         * This method unmaps the file, if it's mapped.
+         */
+        void Unmap() {
+            if (address != nullptr)
+            {
+#if defined(_WIN32)
+                (void)UnmapViewOfFile(address);
+#else
+                (void)munmap((void*)address, length);
+#endif
+            }
+            address = nullptr;
+            length = 0;
+            isOpen = false;
+        }
+    };
+
+    MappedFile::~MappedFile() noexcept {
+        Close();
+    }
+    MappedFile::MappedFile(MappedFile&&) noexcept = default;
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other)
+        {
+            Close();
+            impl_ = std::move(other.impl_);
+        }
+        return *this;
+    }
+
+    MappedFile::MappedFile() : impl_(new Impl()) {
+    }
+
+    bool MappedFile::Open(const std::string& path) {
+        // A file moved away from has no properties, until it's reopened.
+        if (impl_ == nullptr)
+        { impl_.reset(new Impl()); }
+        impl_->Unmap();
+        if (impl_->Map(path))
+        { return true; }
+        impl_->Unmap();
+        return false;
+    }
+
+    void MappedFile::Close() {
+        if (impl_ != nullptr)
+        { impl_->Unmap(); }
+    }
+
+    bool MappedFile::IsOpen() const {
+        return ((impl_ != nullptr) && impl_->isOpen);
+    }
+
+    std::string_view MappedFile::GetContents() const {
+        if ((impl_ == nullptr) || (impl_->address == nullptr))
+        { return std::string_view(); }
+        return std::string_view(impl_->address, impl_->length);
+    }
+
+    MappedSplit::MappedSplit(MappedFile&& file, char d) :
+        file(std::move(file)),
+        pieces(this->file.GetContents(), d) {
+    }
+
+    bool MappedSplit::IsOpen() const {
+        return file.IsOpen();
+    }
+
+    const MappedFile& MappedSplit::GetFile() const {
+        return file;
+    }
+
+    SplitRange::Iterator MappedSplit::begin() const {
+        return pieces.begin();
+    }
+
+    SplitRange::Iterator MappedSplit::end() const {
+        return pieces.end();
+    }
+
+    MappedSplit SplitFile(const std::string& path, char d) {
+        MappedFile file;
+        (void)file.Open(path);
+        return MappedSplit(std::move(file), d);
+    }
+}  // namespace StringUtils
@@ -0,0 +1,141 @@
+#ifndef STRING_UTILS_PROBE_HPP
+#define STRING_UTILS_PROBE_HPP
+/**
+ * @file Probe.hpp
+ *
+ * This module contains the declaration of the StringUtils::Instrumentation
+ * internal probes, which record statistics about calls to StringUtils
+ * functions when the library is built with instrumentation.
+ *
+ * © 2024 by Hatem Nabli
+ */
+
+#include <StringUtils\Instrumentation.hpp>
+
+#if defined(STRING_UTILS_INSTRUMENTATION)
+
+#    include <chrono>
+
+namespace StringUtils
+{
+    namespace Instrumentation
+    {
+        /**
+         * This function returns the number of allocations counted so far
+         * on the calling thread.
+         */
+        uint64_t GetThreadAllocations();
+
+        /**
+         * This function adds one call to the statistics kept by the
+         * calling thread for the given family of functions.
+         *
+         * @param[in] function
+         *      This is the family of functions called.
+         *
+         * @param[in] inputBytes
+         *      This is the number of bytes of input passed in the call.
+         *
+         * @param[in] outputBytes
+         *      This is the number of bytes of text produced by the call.
+         *
+         * @param[in] allocations
+         *      This is the number of allocations counted during the call.
+         *
+         * @param[in] nanoseconds
+         *      This is how long the call took.
+         */
+        void Record(Function function, size_t inputBytes, size_t outputBytes,
+                    uint64_t allocations, uint64_t nanoseconds);
+
+        /**
+         * This records one call to a StringUtils function, from when
+         * it's constructed until it's destroyed.
+         */
+        class Probe
+        {
+            // Lifecycle management
+        public:
+            Probe(Function function, size_t inputBytes) :
+                function(function),
+                inputBytes(inputBytes),
+                allocationsBefore(GetThreadAllocations()),
+                start(std::chrono::steady_clock::now()) {}
+
+            ~Probe() noexcept {
+                const auto elapsed = std::chrono::steady_clock::now() - start;
+                Record(
+                    function, inputBytes, outputBytes, GetThreadAllocations() - allocationsBefore,
+                    (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()
+                );
+            }
+
+            Probe(const Probe&) = delete;
+            Probe& operator=(const Probe&) = delete;
+
+            // Public methods
+        public:
+            /**
+             * This sets the number of bytes of text produced by the call.
+             *
+             * @param[in] outputBytes
+             *      This is the number of bytes of text produced by the call.
+             */
+            void SetOutputBytes(size_t outputBytes) {
+                this->outputBytes = outputBytes;
+            }
+
+            // Private properties
+        private:
+            /**
+             * This is the family of functions called.
+             */
+            Function function;
+
+            /**
+             * This is the number of bytes of input passed in the call.
+             */
+            size_t inputBytes;
+
+            /**
+             * This is the number of bytes of text produced by the call.
+             */
+            size_t outputBytes = 0;
+
+            /**
+             * This is the number of allocations counted on the thread
+             * before the call.
+             */
+            uint64_t allocationsBefore;
+
+            /**
+             * This is when the call began.
+             */
+            std::chrono::steady_clock::time_point start;
+        };
+    }  // namespace Instrumentation
+}  // namespace StringUtils
+
+/**
+ * This records a call to the given family of functions, which is made
+ * with the given number of bytes of input, until the end of the scope.
+ */
+#    define STRING_UTILS_PROBE(function, inputBytes)            \
+        ::StringUtils::Instrumentation::Probe instrumentationProbe( \
+            ::StringUtils::Instrumentation::Function::function, (size_t)(inputBytes))
+
+/**
+ * This sets the number of bytes of text produced by the call
+ * recorded by STRING_UTILS_PROBE.
+ */
+#    define STRING_UTILS_PROBE_OUTPUT(outputBytes) \
+        instrumentationProbe.SetOutputBytes((size_t)(outputBytes))
+
+#else
+
+#    define STRING_UTILS_PROBE(function, inputBytes)
+#    define STRING_UTILS_PROBE_OUTPUT(outputBytes)
+
+#endif /* STRING_UTILS_INSTRUMENTATION */
+
+#endif /*STRING_UTILS_PROBE_HPP*/
@@ -0,0 +1,446 @@
+/**
+ * @file Simd.cpp
+ *
+ * This module contains the implementation of the StringUtils::Simd
+ * internal functions.
+ *
+ * © 2024 by Hatem Nabli
+ */
+
+#include "Simd.hpp"
+
+#include <ctype.h>
+
+#if defined(STRING_UTILS_SIMD_X86)
+#    include <immintrin.h>
+#endif
+
+/**
+ * This is used to compile a function for the given instruction set,
+ * regardless of the instruction sets enabled for the rest of the
+ * program.  Visual C++ needs no such marking to use intrinsics.
+ */
+#if defined(_MSC_VER)
+#    define STRING_UTILS_TARGET(instructionSet)
+#else
+#    define STRING_UTILS_TARGET(instructionSet) __attribute__((target(instructionSet)))
+#endif
+
+namespace
+{
+    using namespace StringUtils::Simd;
+
+    uint64_t ScalarEqual(const char* block, char c) {
+        uint64_t mask = 0;
+        for (size_t i = 0; i < BlockSize; ++i)
+        {
+            if (block[i] == c)
+            { mask |= (uint64_t)1 << i; }
+        }
+        return mask;
+    }
+
+    uint64_t ScalarTrimWhitespace(const char* block) {
+        uint64_t mask = 0;
+        for (size_t i = 0; i < BlockSize; ++i)
+        {
+            if (block[i] <= 32)
+            { mask |= (uint64_t)1 << i; }
+        }
+        return mask;
+    }
+
+    uint64_t ScalarToLowerAscii(const char* block, char* output) {
+        uint64_t mask = 0;
+        for (size_t i = 0; i < BlockSize; ++i)
+        {
+            const auto c = block[i];
+            if ((c >= 'A') && (c <= 'Z'))
+            {
+                output[i] = c + ('a' - 'A');
+            } else
+            {
+                output[i] = c;
+                if (c < 0)
+                { mask |= (uint64_t)1 << i; }
+            }
+        }
+        return mask;
+    }
+
+    size_t ScalarCompress(const char* block, uint64_t keep, char* output) {
+        size_t written = 0;
+        for (; keep != 0; keep &= keep - 1)
+        { output[written++] = block[LowestBit(keep)]; }
+        return written;
+    }
+
+    uint64_t ScalarNonAscii(const char* block) {
+        uint64_t mask = 0;
+        for (size_t i = 0; i < BlockSize; ++i)
+        {
+            if (block[i] < 0)
+            { mask |= (uint64_t)1 << i; }
+        }
+        return mask;
+    }
+
+    const BlockOperations ScalarOperations{
+        Level::Scalar,
+        ScalarEqual,
+        ScalarTrimWhitespace,
+        ScalarToLowerAscii,
+        ScalarCompress,
+        ScalarNonAscii,
+    };
+
+#if defined(STRING_UTILS_SIMD_X86)
+    STRING_UTILS_TARGET("sse2") uint64_t Sse2Equal(const char* block, char c) {
+        const auto needle = _mm_set1_epi8(c);
+        uint64_t mask = 0;
+        for (size_t i = 0; i < BlockSize; i += 16)
+        {
+            const auto chunk = _mm_loadu_si128((const __m128i*)(block + i));
+            mask |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)) << i;
+        }
+        return mask;
+    }
+
+    STRING_UTILS_TARGET("sse2") uint64_t Sse2TrimWhitespace(const char* block) {
+        const auto limit = _mm_set1_epi8(33);
+        uint64_t mask = 0;
+        for (size_t i = 0; i < BlockSize; i += 16)
+        {
+            const auto chunk = _mm_loadu_si128((const __m128i*)(block + i));
+            mask |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmplt_epi8(chunk, limit)) << i;
+        }
+        return mask;
+    }
+
+    STRING_UTILS_TARGET("sse2") uint64_t Sse2ToLowerAscii(const char* block, char* output) {
+        const auto beforeA = _mm_set1_epi8('A' - 1);
+        const auto afterZ = _mm_set1_epi8('Z' + 1);
+        const auto caseBit = _mm_set1_epi8('a' - 'A');
+        uint64_t mask = 0;
+        for (size_t i = 0; i < BlockSize; i += 16)
+        {
+            const auto chunk = _mm_loadu_si128((const __m128i*)(block + i));
+            const auto upper =
+                _mm_and_si128(_mm_cmpgt_epi8(chunk, beforeA), _mm_cmplt_epi8(chunk, afterZ));
+            _mm_storeu_si128((__m128i*)(output + i),
+                             _mm_or_si128(chunk, _mm_and_si128(upper, caseBit)));
+            mask |= (uint64_t)(uint32_t)_mm_movemask_epi8(chunk) << i;
+        }
+        return mask;
+    }
+
+    STRING_UTILS_TARGET("sse2") uint64_t Sse2NonAscii(const char* block) {
+        uint64_t mask = 0;
+        for (size_t i = 0; i < BlockSize; i += 16)
+        {
+            const auto chunk = _mm_loadu_si128((const __m128i*)(block + i));
+            mask |= (uint64_t)(uint32_t)_mm_movemask_epi8(chunk) << i;
+        }
+        return mask;
+    }
+
+    // SSE2 has no byte shuffle, so compaction at this level is scalar.
+    const BlockOperations Sse2Operations{
+        Level::Sse2,
+        Sse2Equal,
+        Sse2TrimWhitespace,
+        Sse2ToLowerAscii,
+        ScalarCompress,
+        Sse2NonAscii,
+    };
+
+    STRING_UTILS_TARGET("avx2") uint64_t Avx2Equal(const char* block, char c) {
+        const auto needle = _mm256_set1_epi8(c);
+        const auto low = _mm256_loadu_si256((const __m256i*)block);
+        const auto high = _mm256_loadu_si256((const __m256i*)(block + 32));
+        return ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, needle))
+                | ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, needle))
+                   << 32));
+    }
+
+    STRING_UTILS_TARGET("avx2") uint64_t Avx2TrimWhitespace(const char* block) {
+        const auto limit = _mm256_set1_epi8(33);
+        const auto low = _mm256_loadu_si256((const __m256i*)block);
+        const auto high = _mm256_loadu_si256((const __m256i*)(block + 32));
+        return ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpgt_epi8(limit, low))
+                | ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpgt_epi8(limit, high))
+                   << 32));
+    }
+
+    STRING_UTILS_TARGET("avx2") uint64_t Avx2ToLowerAscii(const char* block, char* output) {
+        const auto beforeA = _mm256_set1_epi8('A' - 1);
+        const auto afterZ = _mm256_set1_epi8('Z' + 1);
+        const auto caseBit = _mm256_set1_epi8('a' - 'A');
+        uint64_t mask = 0;
+        for (size_t i = 0; i < BlockSize; i += 32)
+        {
+            const auto chunk = _mm256_loadu_si256((const __m256i*)(block + i));
+            const auto upper = _mm256_and_si256(_mm256_cmpgt_epi8(chunk, beforeA),
+                                                _mm256_cmpgt_epi8(afterZ, chunk));
+            _mm256_storeu_si256((__m256i*)(output + i),
+                                _mm256_or_si256(chunk, _mm256_and_si256(upper, caseBit)));
+            mask |= (uint64_t)(uint32_t)_mm256_movemask_epi8(chunk) << i;
+        }
+        return mask;
+    }
+
+    /**
+     * This holds, for every 8-bit mask, the byte shuffle which moves the
+     * bytes marked in the mask, out of a group of eight, to the front.
+     */
+    struct CompressShuffleTable
+    {
+        uint8_t shuffles[256][8];
+    };
+
+    constexpr CompressShuffleTable MakeCompressShuffleTable() {
+        CompressShuffleTable table{};
+        for (size_t mask = 0; mask < 256; ++mask)
+        {
+            size_t next = 0;
+            for (uint8_t bit = 0; bit < 8; ++bit)
+            {
+                if ((mask & ((size_t)1 << bit)) != 0)
+                { table.shuffles[mask][next++] = bit; }
+            }
+            while (next < 8)
+            { table.shuffles[mask][next++] = 0x80; }
+        }
+        return table;
+    }
+
+    constexpr CompressShuffleTable CompressShuffles = MakeCompressShuffleTable();
+
+    STRING_UTILS_TARGET("avx2")
+    size_t Avx2Compress(const char* block, uint64_t keep, char* output) {
+        size_t written = 0;
+        for (size_t i = 0; i < BlockSize; i += 8)
+        {
+            const auto group = (size_t)((keep >> i) & 0xff);
+            const auto chunk = _mm_loadl_epi64((const __m128i*)(block + i));
+            const auto shuffle = _mm_loadl_epi64((const __m128i*)CompressShuffles.shuffles[group]);
+            _mm_storel_epi64((__m128i*)(output + written), _mm_shuffle_epi8(chunk, shuffle));
+            written += CountBits(group);
+        }
+        return written;
+    }
+
+    STRING_UTILS_TARGET("avx2") uint64_t Avx2NonAscii(const char* block) {
+        const auto low = _mm256_loadu_si256((const __m256i*)block);
+        const auto high = _mm256_loadu_si256((const __m256i*)(block + 32));
+        return ((uint64_t)(uint32_t)_mm256_movemask_epi8(low)
+                | ((uint64_t)(uint32_t)_mm256_movemask_epi8(high) << 32));
+    }
+
+    const BlockOperations Avx2Operations{
+        Level::Avx2,
+        Avx2Equal,
+        Avx2TrimWhitespace,
+        Avx2ToLowerAscii,
+        Avx2Compress,
+        Avx2NonAscii,
+    };
+
+    STRING_UTILS_TARGET("avx512f,avx512bw") uint64_t Avx512Equal(const char* block, char c) {
+        return _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(block), _mm512_set1_epi8(c));
+    }
+
+    STRING_UTILS_TARGET("avx512f,avx512bw") uint64_t Avx512TrimWhitespace(const char* block) {
+        return _mm512_cmplt_epi8_mask(_mm512_loadu_si512(block), _mm512_set1_epi8(33));
+    }
+
+    STRING_UTILS_TARGET("avx512f,avx512bw")
+    uint64_t Avx512ToLowerAscii(const char* block, char* output) {
+        const auto chunk = _mm512_loadu_si512(block);
+        const auto upper = (_mm512_cmpgt_epi8_mask(chunk, _mm512_set1_epi8('A' - 1))
+                            & _mm512_cmplt_epi8_mask(chunk, _mm512_set1_epi8('Z' + 1)));
+        _mm512_storeu_si512(output,
+                            _mm512_mask_add_epi8(chunk, upper, chunk, _mm512_set1_epi8('a' - 'A')));
+        return _mm512_movepi8_mask(chunk);
+    }
+
+    STRING_UTILS_TARGET("avx512f,avx512bw") uint64_t Avx512NonAscii(const char* block) {
+        return _mm512_movepi8_mask(_mm512_loadu_si512(block));
+    }
+
+    STRING_UTILS_TARGET("avx512f,avx512bw,avx512vbmi2")
+    size_t Avx512Vbmi2Compress(const char* block, uint64_t keep, char* output) {
+        const auto chunk = _mm512_loadu_si512(block);
+        _mm512_storeu_si512(output, _mm512_maskz_compress_epi8(keep, chunk));
+        return CountBits(keep);
+    }
+
+    const BlockOperations Avx512Operations{
+        Level::Avx512,
+        Avx512Equal,
+        Avx512TrimWhitespace,
+        Avx512ToLowerAscii,
+        Avx2Compress,
+        Avx512NonAscii,
+    };
+
+    // Byte compression (VBMI2) came later than the rest of AVX-512BW,
+    // so it's used only where the processor supports it.
+    const BlockOperations Avx512Vbmi2Operations{
+        Level::Avx512,
+        Avx512Equal,
+        Avx512TrimWhitespace,
+        Avx512ToLowerAscii,
+        Avx512Vbmi2Compress,
+        Avx512NonAscii,
+    };
+
+    /**
+     * This function asks the processor (and operating system) whether
+     * or not the given level of instruction set may be used.
+     *
+     * @param[in] level
+     *      This is the level of instruction set to check.
+     *
+     * @return
+     *      An indication of whether or not the given level may be used
+     *      is returned.
+     */
+    bool DetectSupport(Level level) {
+#    if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        const auto highestFunction = info[0];
+        __cpuid(info, 1);
+        const bool sse2 = ((info[3] & (1 << 26)) != 0);
+        const bool osxsave = ((info[2] & (1 << 27)) != 0);
+        bool avx2 = false, avx512bw = false;
+        if (osxsave && (highestFunction >= 7))
+        {
+            const auto xcr0 = _xgetbv(0);
+            __cpuidex(info, 7, 0);
+            avx2 = (((info[1] & (1 << 5)) != 0) && ((xcr0 & 0x06) == 0x06));
+            avx512bw = (((info[1] & (1 << 16)) != 0) && ((info[1] & (1 << 30)) != 0)
+                        && ((xcr0 & 0xe6) == 0xe6));
+        }
+#    else
+        __builtin_cpu_init();
+        const bool sse2 = __builtin_cpu_supports("sse2");
+        const bool avx2 = __builtin_cpu_supports("avx2");
+        const bool avx512bw =
+            (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"));
+#    endif
+        switch (level)
+        {
+        case Level::Scalar:
+            return true;
+        case Level::Sse2:
+            return sse2;
+        case Level::Avx2:
+            return avx2;
+        case Level::Avx512:
+            return avx512bw;
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * This function asks the processor (and operating system) whether
+     * or not the AVX-512 byte compression instructions may be used.
+     *
+     * @return
+     *      An indication of whether or not the AVX-512 byte compression
+     *      instructions may be used is returned.
+     */
+    bool DetectVbmi2Support() {
+        if (!DetectSupport(Level::Avx512))
+        { return false; }
+#    if defined(_MSC_VER)
+        int info[4];
+        __cpuidex(info, 7, 0);
+        return ((info[2] & (1 << 6)) != 0);
+#    else
+        return __builtin_cpu_supports("avx512vbmi2");
+#    endif
+    }
+#else
+    bool DetectSupport(Level level) {
+        return (level == Level::Scalar);
+    }
+#endif
+
+    /**
+     * This function returns the block operations for the widest
+     * instruction set supported by the processor.
+     *
+     * @return
+     *      The block operations to use are returned.
+     */
+    const BlockOperations& SelectBlockOperations() {
+        for (auto level : {Level::Avx512, Level::Avx2, Level::Sse2})
+        {
+            if (IsSupported(level))
+            { return GetBlockOperations(level); }
+        }
+        return ScalarOperations;
+    }
+}  // namespace
+
+namespace StringUtils
+{
+    namespace Simd
+    {
+        bool IsSupported(Level level) {
+            return DetectSupport(level);
+        }
+
+        const BlockOperations& GetBlockOperations() {
+            static const BlockOperations& best = SelectBlockOperations();
+            return best;
+        }
+
+        void ToLower(const BlockOperations& operations, const char* input, char* output,
+                     size_t length) {
+            char tail[BlockSize];
+            for (size_t blockBegin = 0; blockBegin < length; blockBegin += BlockSize)
+            {
+                const auto blockLength = std::min(BlockSize, length - blockBegin);
+                const char* block = input + blockBegin;
+                char* blockOutput = output + blockBegin;
+                if (blockLength < BlockSize)
+                {
+                    (void)memcpy(tail, block, blockLength);
+                    (void)memset(tail + blockLength, 0, BlockSize - blockLength);
+                    block = blockOutput = tail;
+                }
+                auto nonAscii =
+                    (operations.toLowerAscii(block, blockOutput) & BitsBelow(blockLength));
+                while (nonAscii != 0)
+                {
+                    const auto i = LowestBit(nonAscii);
+                    blockOutput[i] = (char)tolower(block[i]);
+                    nonAscii &= nonAscii - 1;
+                }
+                if (blockLength < BlockSize)
+                { (void)memcpy(output + blockBegin, tail, blockLength); }
+            }
+        }
+
+        const BlockOperations& GetBlockOperations(Level level) {
+            switch (level)
+            {
+#if defined(STRING_UTILS_SIMD_X86)
+            case Level::Sse2:
+                return Sse2Operations;
+            case Level::Avx2:
+                return Avx2Operations;
+            case Level::Avx512:
+                return (DetectVbmi2Support() ? Avx512Vbmi2Operations : Avx512Operations);
+#endif
+            default:
+                return ScalarOperations;
+            }
+        }
+    }  // namespace Simd
+}  // namespace StringUtils
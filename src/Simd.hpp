@@ -0,0 +1,395 @@
+#ifndef STRING_UTILS_SIMD_HPP
+#define STRING_UTILS_SIMD_HPP
+/**
+ * @file Simd.hpp
+ *
+ * This module contains the declaration of the StringUtils::Simd
+ * internal functions, which classify blocks of characters using
+ * the widest vector instructions supported by the processor.
+ *
+ * © 2024 by Hatem Nabli
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#    define STRING_UTILS_SIMD_X86
+#endif
+
+#if defined(_MSC_VER)
+#    include <intrin.h>
+#endif
+
+namespace StringUtils
+{
+    namespace Simd
+    {
+        /**
+         * This is the number of characters classified at a time.
+         * Each character of a block corresponds to one bit of a mask.
+         */
+        constexpr size_t BlockSize = 64;
+
+        /**
+         * These are the instruction sets for which block operations
+         * are implemented, from narrowest to widest.
+         */
+        enum class Level
+        {
+            /**
+             * This is plain C++, which works on any processor.
+             */
+            Scalar,
+
+            /**
+             * This is SSE2 (16 characters per instruction).
+             */
+            Sse2,
+
+            /**
+             * This is AVX2 (32 characters per instruction).
+             */
+            Avx2,
+
+            /**
+             * This is AVX-512BW (64 characters per instruction).
+             */
+            Avx512
+        };
+
+        /**
+         * This holds the block operations implemented for one level of
+         * instruction set.  Every operation classifies exactly BlockSize
+         * characters, returning a mask where bit N is set if the
+         * corresponding condition holds for character N of the block.
+         */
+        struct BlockOperations
+        {
+            /**
+             * This is the instruction set used by the operations.
+             */
+            Level level;
+
+            /**
+             * This marks the characters equal to the given character.
+             */
+            uint64_t (*equal)(const char* block, char c);
+
+            /**
+             * This marks the characters considered whitespace by Trim.
+             */
+            uint64_t (*trimWhitespace)(const char* block);
+
+            /**
+             * This copies the block to the given output, converting ASCII
+             * upper-case letters to lower-case, and marks the characters
+             * which are not ASCII (and so are copied unchanged).
+             * The output may be the same as the block.
+             */
+            uint64_t (*toLowerAscii)(const char* block, char* output);
+
+            /**
+             * This writes the characters of the block marked in the given
+             * mask to the given output, one after another, returning how
+             * many were written.  Up to a full block of characters may be
+             * stored, with those past the ones marked left undefined.
+             * The output may be the same as the block, or before it.
+             */
+            size_t (*compress)(const char* block, uint64_t keep, char* output);
+
+            /**
+             * This marks the characters which are not ASCII.
+             */
+            uint64_t (*nonAscii)(const char* block);
+        };
+
+        /**
+         * This function determines whether or not the processor running
+         * the program supports the given level of instruction set.
+         *
+         * @param[in] level
+         *      This is the level of instruction set to check.
+         *
+         * @return
+         *      An indication of whether or not the given level is supported
+         *      is returned.
+         */
+        bool IsSupported(Level level);
+
+        /**
+         * This function returns the block operations for the widest
+         * instruction set supported by the processor.  The processor is
+         * only examined the first time this function is called.
+         *
+         * @return
+         *      The block operations to use are returned.
+         */
+        const BlockOperations& GetBlockOperations();
+
+        /**
+         * This function returns the block operations for the given
+         * level of instruction set, which must be supported.
+         *
+         * @param[in] level
+         *      This is the level of instruction set to use.
+         *
+         * @return
+         *      The block operations for the given level are returned.
+         */
+        const BlockOperations& GetBlockOperations(Level level);
+
+        /**
+         * This function copies the given characters to the given output,
+         * converting upper-case letters to lower-case the same way the
+         * C "tolower" function does.  ASCII characters are converted a
+         * block at a time, and "tolower" is only called for characters
+         * which are not ASCII.
+         *
+         * @param[in] operations
+         *      These are the block operations to use.
+         *
+         * @param[in] input
+         *      These are the characters to convert.
+         *
+         * @param[out] output
+         *      This is where to store the converted characters.
+         *      It may be the same as the input.
+         *
+         * @param[in] length
+         *      This is the number of characters to convert.
+         */
+        void ToLower(const BlockOperations& operations, const char* input, char* output,
+                     size_t length);
+
+        /**
+         * This function returns the index of the lowest set bit
+         * in the given mask, which must not be zero.
+         */
+        inline unsigned int LowestBit(uint64_t mask) {
+#if defined(_MSC_VER) && defined(_M_X64)
+            unsigned long index;
+            (void)_BitScanForward64(&index, mask);
+            return (unsigned int)index;
+#elif defined(_MSC_VER)
+            unsigned long index;
+            if (_BitScanForward(&index, (unsigned long)mask))
+            { return (unsigned int)index; }
+            (void)_BitScanForward(&index, (unsigned long)(mask >> 32));
+            return (unsigned int)index + 32;
+#else
+            return (unsigned int)__builtin_ctzll(mask);
+#endif
+        }
+
+        /**
+         * This function returns the index of the highest set bit
+         * in the given mask, which must not be zero.
+         */
+        inline unsigned int HighestBit(uint64_t mask) {
+#if defined(_MSC_VER) && defined(_M_X64)
+            unsigned long index;
+            (void)_BitScanReverse64(&index, mask);
+            return (unsigned int)index;
+#elif defined(_MSC_VER)
+            unsigned long index;
+            if (_BitScanReverse(&index, (unsigned long)(mask >> 32)))
+            { return (unsigned int)index + 32; }
+            (void)_BitScanReverse(&index, (unsigned long)mask);
+            return (unsigned int)index;
+#else
+            return 63 - (unsigned int)__builtin_clzll(mask);
+#endif
+        }
+
+        /**
+         * This function returns the number of set bits
+         * in the given mask.
+         */
+        inline unsigned int CountBits(uint64_t mask) {
+#if defined(_MSC_VER)
+            mask -= (mask >> 1) & 0x5555555555555555;
+            mask = (mask & 0x3333333333333333) + ((mask >> 2) & 0x3333333333333333);
+            mask = (mask + (mask >> 4)) & 0x0f0f0f0f0f0f0f0f;
+            return (unsigned int)((mask * 0x0101010101010101) >> 56);
+#else
+            return (unsigned int)__builtin_popcountll(mask);
+#endif
+        }
+
+        /**
+         * This function returns a mask with the bits at and above
+         * the given index set.
+         */
+        inline uint64_t BitsFrom(size_t index) {
+            return ((index >= 64) ? 0 : (~(uint64_t)0 << index));
+        }
+
+        /**
+         * This function returns a mask with the bits below
+         * the given index set.
+         */
+        inline uint64_t BitsBelow(size_t index) {
+            return ~BitsFrom(index);
+        }
+
+        /**
+         * This function breaks the given string at each instance of the
+         * given delimiter character, handing each piece, trimmed the same
+         * way Split trims them, to the given visitor as a view into the
+         * string.
+         *
+         * Delimiters and whitespace are located a block at a time, so that
+         * piece boundaries and trim positions come straight from bit masks.
+         *
+         * @param[in] operations
+         *      These are the block operations to use.
+         *
+         * @param[in] s
+         *      This is the string to split.
+         *
+         * @param[in] d
+         *      This is the delimiter character at which to split the string.
+         *
+         * @param[in] visit
+         *      This is the function to call with each piece.
+         */
+        template <typename Visitor>
+        void SplitByCharacter(const BlockOperations& operations, std::string_view s, char d,
+                              Visitor visit) {
+            bool inPiece = false;
+            size_t pieceBegin = 0;
+            size_t pieceEnd = 0;
+            char tail[BlockSize];
+            for (size_t blockBegin = 0; blockBegin < s.length(); blockBegin += BlockSize)
+            {
+                const char* block = s.data() + blockBegin;
+                const auto blockLength = std::min(BlockSize, s.length() - blockBegin);
+                if (blockLength < BlockSize)
+                {
+                    (void)memcpy(tail, block, blockLength);
+                    (void)memset(tail + blockLength, 0, BlockSize - blockLength);
+                    block = tail;
+                }
+                const auto valid = BitsBelow(blockLength);
+                const auto delimiters = operations.equal(block, d) & valid;
+                const auto content = ~operations.trimWhitespace(block) & valid;
+                auto remaining = valid;
+                for (;;)
+                {
+                    if (!inPiece)
+                    {
+                        const auto starts = content & remaining;
+                        if (starts == 0)
+                        { break; }
+                        const auto start = LowestBit(starts);
+                        inPiece = true;
+                        pieceBegin = pieceEnd = blockBegin + start;
+                        remaining &= BitsFrom(start);
+                    }
+                    const auto ends = delimiters & remaining;
+                    if (ends == 0)
+                    {
+                        const auto pieceContent = content & remaining;
+                        if (pieceContent != 0)
+                        { pieceEnd = blockBegin + HighestBit(pieceContent) + 1; }
+                        break;
+                    }
+                    const auto end = LowestBit(ends);
+                    const auto pieceContent = content & remaining & BitsBelow(end);
+                    if (pieceContent != 0)
+                    { pieceEnd = blockBegin + HighestBit(pieceContent) + 1; }
+                    visit(s.substr(pieceBegin, pieceEnd - pieceBegin));
+                    inPiece = false;
+                    remaining &= BitsFrom(end + 1);
+                }
+            }
+            if (inPiece)
+            { visit(s.substr(pieceBegin, pieceEnd - pieceBegin)); }
+        }
+
+        /**
+         * This function classifies the given string a block at a time,
+         * handing the given visitor the offset of each block along with
+         * the mask the given classifier produced for it.  Bits of the
+         * mask beyond the end of the string are cleared.
+         *
+         * @param[in] s
+         *      This is the string to classify.
+         *
+         * @param[in] classify
+         *      This is the function which returns the mask for a block.
+         *
+         * @param[in] visit
+         *      This is the function to call with each block's offset
+         *      and mask.
+         */
+        template <typename Classifier, typename Visitor>
+        void ForEachBlock(std::string_view s, Classifier classify, Visitor visit) {
+            char tail[BlockSize];
+            for (size_t blockBegin = 0; blockBegin < s.length(); blockBegin += BlockSize)
+            {
+                const char* block = s.data() + blockBegin;
+                const auto blockLength = std::min(BlockSize, s.length() - blockBegin);
+                if (blockLength < BlockSize)
+                {
+                    (void)memcpy(tail, block, blockLength);
+                    (void)memset(tail + blockLength, 0, BlockSize - blockLength);
+                    block = tail;
+                }
+                visit(blockBegin, classify(block) & BitsBelow(blockLength));
+            }
+        }
+
+        /**
+         * This function hands the position of each instance of either of
+         * the given characters in the given string, in order, to the given
+         * visitor, until the visitor returns false.
+         *
+         * @param[in] operations
+         *      These are the block operations to use.
+         *
+         * @param[in] s
+         *      This is the string to search.
+         *
+         * @param[in] first
+         *      This is one of the characters to find.
+         *
+         * @param[in] second
+         *      This is the other character to find.
+         *
+         * @param[in] visit
+         *      This is the function to call with each position.
+         *      It returns whether or not to continue searching.
+         */
+        template <typename Visitor>
+        void FindEither(const BlockOperations& operations, std::string_view s, char first,
+                        char second, Visitor visit) {
+            char tail[BlockSize];
+            for (size_t blockBegin = 0; blockBegin < s.length(); blockBegin += BlockSize)
+            {
+                const char* block = s.data() + blockBegin;
+                const auto blockLength = std::min(BlockSize, s.length() - blockBegin);
+                if (blockLength < BlockSize)
+                {
+                    (void)memcpy(tail, block, blockLength);
+                    (void)memset(tail + blockLength, 0, BlockSize - blockLength);
+                    block = tail;
+                }
+                auto found = ((operations.equal(block, first) | operations.equal(block, second))
+                              & BitsBelow(blockLength));
+                while (found != 0)
+                {
+                    if (!visit(blockBegin + LowestBit(found)))
+                    { return; }
+                    found &= found - 1;
+                }
+            }
+        }
+    }  // namespace Simd
+}  // namespace StringUtils
+
+#endif /*STRING_UTILS_SIMD_HPP*/
@@ -6,32 +6,1878 @@
  * © 2024 by Hatem Nabli
  */
 
+#include "Probe.hpp"
+#include "Simd.hpp"
+
 #include <StringUtils\StringUtils.hpp>
+#include <algorithm>
+#include <charconv>
+#include <exception>
+#include <float.h>
+#include <limits>
+#include <type_traits>
+#include <stddef.h>
+#include <string.h>
+#include <thread>
+
+#if !defined(_WIN32)
+#    include <sys/uio.h>
+#endif
+
+namespace
+{
+    /**
+     * This function determines whether or not the given character
+     * is considered whitespace for the purpose of trimming.
+     *
+     * @param[in] c
+     *      This is the character to check.
+     *
+     * @return
+     *      An indication of whether or not the given character
+     *      is whitespace is returned.
+     */
+    bool IsTrimWhitespace(char c) {
+        return c <= 32;
+    }
+
+    /**
+     * This function breaks the given string at each instance of the
+     * given delimiter character, handing each piece, trimmed the same
+     * way Split trims them, to the given visitor.  Vector instructions
+     * are used to do this if the processor supports them.
+     *
+     * @param[in] s
+     *      This is the string to split.
+     *
+     * @param[in] d
+     *      This is the delimiter character at which to split the string.
+     *
+     * @param[in] visit
+     *      This is the function to call with each piece.
+     */
+    template <typename Visitor>
+    void SplitByCharacter(std::string_view s, char d, Visitor visit) {
+        const auto& operations = StringUtils::Simd::GetBlockOperations();
+        if (operations.level == StringUtils::Simd::Level::Scalar)
+        {
+            for (auto piece : StringUtils::SplitRange(s, d))
+            { visit(piece); }
+        } else
+        { StringUtils::Simd::SplitByCharacter(operations, s, d, visit); }
+    }
+
+    /**
+     * This function breaks the given template into literal text and
+     * substitution markers, handing each, in order, to the corresponding
+     * given function.  Literal text is handed over as views into the
+     * template, with escape characters left out.
+     *
+     * @param[in] templateText
+     *     This is the template to parse.
+     *
+     * @param[in] onLiteral
+     *     This is the function to call with each piece of literal text.
+     *
+     * @param[in] onVariable
+     *     This is the function to call with the name of the variable
+     *     in each substitution marker.
+     */
+    template <typename OnLiteral, typename OnVariable>
+    void ParseTemplate(std::string_view templateText, OnLiteral onLiteral, OnVariable onVariable) {
+        enum class State
+        {
+            Normal,
+            Escape,
+            TokenStart,
+            Token,
+        } state = State::Normal;
+        size_t tokenStart = 0;
+        for (size_t i = 0; i < templateText.length(); ++i)
+        {
+            const auto c = templateText[i];
+            switch (state)
+            {
+            case State::Normal: {
+                if (c == '\\')
+                {
+                    state = State::Escape;
+                } else if (c == '$')
+                {
+                    state = State::TokenStart;
+                } else
+                {
+                    size_t end = i + 1;
+                    while ((end < templateText.length()) && (templateText[end] != '\\')
+                           && (templateText[end] != '$'))
+                    { ++end; }
+                    onLiteral(templateText.substr(i, end - i));
+                    i = end - 1;
+                }
+            }
+            break;
+
+            case State::Escape: {
+                state = State::Normal;
+                onLiteral(templateText.substr(i, 1));
+            }
+            break;
+
+            case State::TokenStart: {
+                if (c == '{')
+                {
+                    state = State::Token;
+                    tokenStart = i + 1;
+                } else
+                {
+                    state = State::Normal;
+                    onLiteral(templateText.substr(i - 1, 2));
+                }
+            }
+            break;
+
+            case State::Token: {
+                if (c == '}')
+                {
+                    onVariable(templateText.substr(tokenStart, i - tokenStart));
+                    state = State::Normal;
+                }
+            }
+            break;
+
+            default:
+                break;
+            }
+        }
+    }
+
+    /**
+     * This function instantiates the given template in a single pass,
+     * appending it to the given string, and looking up each variable
+     * as its substitution marker is found.
+     *
+     * @param[in] templateText
+     *     This is the template to instantiate.
+     *
+     * @param[in] variables
+     *     This holds the values of variables which may be substituted
+     *     in the template.
+     *
+     * @param[in,out] output
+     *     This is where to append the instantiated template.
+     */
+    template <typename String>
+    void AppendInstantiatedTemplate(std::string_view templateText,
+                                    const std::map<std::string, std::string>& variables,
+                                    String& output) {
+        // The map can only be searched by std::string, so one key is
+        // reused for every lookup, to allocate only as names grow longer.
+        std::string key;
+        ParseTemplate(
+            templateText, [&output](std::string_view text) { output += text; },
+            [&variables, &output, &key](std::string_view name) {
+                key.assign(name.data(), name.length());
+                const auto variablesEntry = variables.find(key);
+                if (variablesEntry != variables.end())
+                { output += variablesEntry->second; }
+            });
+    }
+
+    /**
+     * This function returns a function which, given the slot index of
+     * a template variable, looks up the variable by name in the given
+     * collection of variables, returning a pointer to its value, or
+     * nullptr if it is not in the collection.
+     *
+     * @param[in] variableNames
+     *     These are the names of the template variables, in slot order.
+     *
+     * @param[in] variables
+     *     This holds the values of variables.
+     *
+     * @return
+     *     The lookup function is returned.
+     */
+    template <typename Variables>
+    auto VariableLookup(const std::vector<std::string>& variableNames, const Variables& variables) {
+        return [&variableNames, &variables](size_t variable) -> const std::string* {
+            const auto variablesEntry = variables.find(variableNames[variable]);
+            return ((variablesEntry == variables.end()) ? nullptr : &variablesEntry->second);
+        };
+    }
+
+    /**
+     * This function returns a function which, given the slot index of
+     * a template variable, returns a pointer to the value at that index
+     * of the given values, or nullptr if there is no such value.
+     *
+     * @param[in] values
+     *     These are the values of the variables, in slot order.
+     *
+     * @return
+     *     The lookup function is returned.
+     */
+    auto SlotLookup(const std::vector<std::string_view>& values) {
+        return [&values](size_t variable) -> const std::string_view* {
+            return ((variable < values.size()) ? &values[variable] : nullptr);
+        };
+    }
+
+    /**
+     * This function returns the length of the string formed by
+     * concatenating the given pieces, separated by the given delimiter.
+     *
+     * @param[in] v
+     *     This is the sequence of pieces to join together.
+     *
+     * @param[in] d
+     *     This is the delimiter used as glue between pieces.
+     *
+     * @return
+     *     The length of the joined string is returned.
+     */
+    template <typename Pieces> size_t JoinedLength(const Pieces& v, std::string_view d) {
+        if (v.empty())
+        { return 0; }
+        size_t length = d.length() * (v.size() - 1);
+        for (const auto& piece : v)
+        { length += piece.length(); }
+        return length;
+    }
+
+    /**
+     * This function concatenates the given pieces, separated by the
+     * given delimiter, into a string whose exact length is computed
+     * beforehand, so that it is allocated only once.
+     *
+     * @param[in] v
+     *     This is the sequence of pieces to join together.
+     *
+     * @param[in] d
+     *     This is the delimiter used as glue between pieces.
+     *
+     * @return
+     *     The joined string is returned.
+     */
+    std::string JoinPieces(const std::vector<std::string>& v, std::string_view d) {
+        STRING_UTILS_PROBE(Join, JoinedLength(v, {}));
+        StringUtils::StringBuilder output;
+        output.Reserve(JoinedLength(v, d));
+        bool first = true;
+        for (const auto& piece : v)
+        {
+            if (first)
+            {
+                first = false;
+            } else
+            { output.Append(d); }
+            output.Append(piece);
+        }
+        STRING_UTILS_PROBE_OUTPUT(output.GetLength());
+        return output.Finish();
+    }
+
+    /**
+     * This function concatenates the given pieces, separated by the
+     * given delimiter, into a string allocated from the given memory
+     * resource, whose exact length is computed beforehand, so that it
+     * is allocated only once.
+     *
+     * @param[in] v
+     *     This is the sequence of pieces to join together.
+     *
+     * @param[in] d
+     *     This is the delimiter used as glue between pieces.
+     *
+     * @param[in] resource
+     *     This is the memory resource from which to allocate the result.
+     *
+     * @return
+     *     The joined string is returned.
+     */
+    std::pmr::string JoinPieces(const std::pmr::vector<std::pmr::string>& v, std::string_view d,
+                                std::pmr::memory_resource* resource) {
+        STRING_UTILS_PROBE(Join, JoinedLength(v, {}));
+        std::pmr::string output(resource);
+        output.reserve(JoinedLength(v, d));
+        bool first = true;
+        for (const auto& piece : v)
+        {
+            if (first)
+            {
+                first = false;
+            } else
+            { output += d; }
+            output += piece;
+        }
+        STRING_UTILS_PROBE_OUTPUT(output.length());
+        return output;
+    }
+
+    /**
+     * This is the least number of characters worth handing to a thread
+     * of its own when splitting or joining strings in parallel.
+     */
+    constexpr size_t MinimumParallelChunkLength = 64 * 1024;
+
+    /**
+     * This function decides how many threads to use to split or join
+     * a string of the given length.
+     *
+     * @param[in] length
+     *     This is the length of the string to split or join.
+     *
+     * @param[in] threads
+     *     This is the most threads to use, or zero to use one thread
+     *     per processor core.
+     *
+     * @return
+     *     The number of threads to use is returned.
+     */
+    size_t ChooseThreadCount(size_t length, size_t threads) {
+        if (threads == 0)
+        { threads = std::max(std::thread::hardware_concurrency(), 1u); }
+        return std::max((size_t)1, std::min(threads, length / MinimumParallelChunkLength));
+    }
+
+    /**
+     * This function calls the given function with each worker index from
+     * zero up to the given number of workers, each on a different thread,
+     * the first being the calling thread, and returns once every call has
+     * returned.  If any of the calls throws an exception, the exception
+     * is thrown again on the calling thread.
+     *
+     * @param[in] workers
+     *     This is the number of times to call the function.
+     *
+     * @param[in] work
+     *     This is the function to call with each worker index.
+     */
+    template <typename Work> void RunInParallel(size_t workers, Work work) {
+        std::vector<std::exception_ptr> exceptions(workers);
+        const auto runWorker = [&work, &exceptions](size_t worker) {
+            try
+            {
+                work(worker);
+            } catch (...)
+            { exceptions[worker] = std::current_exception(); }
+        };
+        std::vector<std::thread> threads;
+        threads.reserve(workers - 1);
+        for (size_t worker = 1; worker < workers; ++worker)
+        { threads.emplace_back(runWorker, worker); }
+        runWorker(0);
+        for (auto& thread : threads)
+        { thread.join(); }
+        for (const auto& exception : exceptions)
+        {
+            if (exception != nullptr)
+            { std::rethrow_exception(exception); }
+        }
+    }
+
+    /**
+     * This function breaks the given string at each instance of the given
+     * delimiter character, the same way Split does, using the given number
+     * of threads.  The string is first broken into chunks, each ending just
+     * past a delimiter, so that no piece straddles two chunks, and the
+     * chunks are split at the same time.  The pieces of each chunk are then
+     * stored, again at the same time, where they belong in the result.
+     *
+     * @param[in] s
+     *     This is the string to split.
+     *
+     * @param[in] d
+     *     This is the delimiter character at which to split the string.
+     *
+     * @param[in] workers
+     *     This is the number of threads to use.
+     *
+     * @return
+     *     The pieces of the string are returned.
+     */
+    template <typename Piece>
+    std::vector<Piece> SplitInParallel(std::string_view s, char d, size_t workers) {
+        std::vector<size_t> chunkBegins(workers + 1, s.length());
+        chunkBegins[0] = 0;
+        for (size_t worker = 1; worker < workers; ++worker)
+        {
+            const auto target = std::max(chunkBegins[worker - 1], s.length() / workers * worker);
+            const auto delimiter = s.find(d, target);
+            if (delimiter == std::string_view::npos)
+            { break; }
+            chunkBegins[worker] = delimiter + 1;
+        }
+        std::vector<std::vector<std::string_view>> chunkPieces(workers);
+        RunInParallel(workers, [&](size_t worker) {
+            const auto chunk = s.substr(chunkBegins[worker],
+                                        chunkBegins[worker + 1] - chunkBegins[worker]);
+            auto& pieces = chunkPieces[worker];
+            SplitByCharacter(chunk, d, [&pieces](std::string_view piece) {
+                pieces.push_back(piece);
+            });
+        });
+        std::vector<size_t> firstPieces(workers + 1, 0);
+        for (size_t worker = 0; worker < workers; ++worker)
+        { firstPieces[worker + 1] = firstPieces[worker] + chunkPieces[worker].size(); }
+        std::vector<Piece> values(firstPieces[workers]);
+        RunInParallel(workers, [&](size_t worker) {
+            auto value = values.begin() + firstPieces[worker];
+            for (auto piece : chunkPieces[worker])
+            { *value++ = piece; }
+        });
+        return values;
+    }
+
+    /**
+     * This function hands the offset just past each line terminator
+     * in the given string, in order, to the given visitor.  Line feeds
+     * (and carriage returns, if they can end lines by themselves) are
+     * located a block at a time.
+     *
+     * @param[in] s
+     *      This is the string containing the lines.
+     *
+     * @param[in] lineEnding
+     *      This indicates how lines are terminated.
+     *
+     * @param[in] visit
+     *      This is the function to call with the end of each terminator.
+     */
+    template <typename Visitor>
+    void ForEachLineEnd(std::string_view s, StringUtils::LineEnding lineEnding, Visitor visit) {
+        const auto& operations = StringUtils::Simd::GetBlockOperations();
+        const bool bareCarriageReturns = (lineEnding == StringUtils::LineEnding::Any);
+        StringUtils::Simd::ForEachBlock(
+            s,
+            [&](const char* block) {
+                auto mask = operations.equal(block, '\n');
+                if (bareCarriageReturns)
+                { mask |= operations.equal(block, '\r'); }
+                return mask;
+            },
+            [&](size_t blockBegin, uint64_t mask) {
+                for (; mask != 0; mask &= mask - 1)
+                {
+                    const auto position = blockBegin + StringUtils::Simd::LowestBit(mask);
+                    if (s[position] == '\r')
+                    {
+                        if ((position + 1 < s.length()) && (s[position + 1] == '\n'))
+                        { continue; }
+                    } else if ((lineEnding == StringUtils::LineEnding::CrLf)
+                               && ((position == 0) || (s[position - 1] != '\r')))
+                    { continue; }
+                    visit(position + 1);
+                }
+            });
+    }
+
+    /**
+     * This function breaks up the given string into lines, according
+     * to the given kind of line terminators, and appends them to the given
+     * output, indenting all lines except the first (unless asked to
+     * indent the first too).  The number of lines to indent is counted
+     * first, so that the output grows only once, and then the lines are
+     * copied in bulk.
+     *
+     * @param[in] linesIn
+     *      This is the string containing the lines to indent.
+     *
+     * @param[in] spaces
+     *      This is the number of spaces to indent each line but the first.
+     *
+     * @param[in] lineEnding
+     *      This indicates how lines are terminated.
+     *
+     * @param[in] indentFirstLine
+     *      This indicates whether or not to indent the first line too.
+     *
+     * @param[in,out] linesOut
+     *      This is where to append the indented text.
+     */
+    template <typename String>
+    void IndentLines(std::string_view linesIn, size_t spaces, StringUtils::LineEnding lineEnding,
+                     bool indentFirstLine, String& linesOut) {
+        if (linesIn.empty())
+        { return; }
+        size_t indents = (indentFirstLine ? 1 : 0);
+        ForEachLineEnd(linesIn, lineEnding, [&](size_t lineEnd) {
+            if (lineEnd < linesIn.length())
+            { ++indents; }
+        });
+        const auto outputBegin = linesOut.length();
+        linesOut.resize(outputBegin + linesIn.length() + indents * spaces);
+        auto output = &linesOut[outputBegin];
+        if (indentFirstLine)
+        {
+            (void)memset(output, ' ', spaces);
+            output += spaces;
+        }
+        size_t copied = 0;
+        ForEachLineEnd(linesIn, lineEnding, [&](size_t lineEnd) {
+            if (lineEnd == linesIn.length())
+            { return; }
+            (void)memcpy(output, linesIn.data() + copied, lineEnd - copied);
+            output += lineEnd - copied;
+            (void)memset(output, ' ', spaces);
+            output += spaces;
+            copied = lineEnd;
+        });
+        (void)memcpy(output, linesIn.data() + copied, linesIn.length() - copied);
+    }
+
+    /**
+     * This is the most characters an EscapeSpec may have for them to be
+     * matched a block at a time, rather than one character at a time.
+     */
+    constexpr size_t MaxBlockEscapeCharacters = 8;
+
+    /**
+     * This function marks the characters of the given block which
+     * the given specification says are to be escaped.
+     *
+     * @param[in] operations
+     *     These are the block operations to use.
+     *
+     * @param[in] spec
+     *     This specifies which characters to escape.
+     *
+     * @param[in] block
+     *     This is the block of characters to classify.
+     *
+     * @return
+     *     A mask marking the characters to escape is returned.
+     */
+    uint64_t EscapeMask(const StringUtils::Simd::BlockOperations& operations,
+                        const StringUtils::EscapeSpec& spec, const char* block) {
+        const auto characters = spec.GetCharacters();
+        uint64_t mask = 0;
+        if (characters.length() <= MaxBlockEscapeCharacters)
+        {
+            for (auto c : characters)
+            { mask |= operations.equal(block, c); }
+        } else
+        {
+            for (size_t i = 0; i < StringUtils::Simd::BlockSize; ++i)
+            {
+                if (spec.IsEscaped(block[i]))
+                { mask |= (uint64_t)1 << i; }
+            }
+        }
+        return mask;
+    }
+
+    /**
+     * This function returns the length of the escaped copy
+     * of the given string.
+     *
+     * @param[in] s
+     *     This is the input string.
+     *
+     * @param[in] spec
+     *     This specifies which characters to escape.
+     *
+     * @return
+     *     The length of the escaped copy of the given string is returned.
+     */
+    size_t EscapedLength(std::string_view s, const StringUtils::EscapeSpec& spec) {
+        const auto& operations = StringUtils::Simd::GetBlockOperations();
+        size_t length = s.length();
+        StringUtils::Simd::ForEachBlock(
+            s, [&](const char* block) { return EscapeMask(operations, spec, block); },
+            [&](size_t, uint64_t mask) { length += StringUtils::Simd::CountBits(mask); });
+        return length;
+    }
+
+    /**
+     * This function writes a copy of the given input string to the given
+     * output, with every character the given specification says to escape
+     * prefixed by its escape character.  Runs of characters which aren't
+     * escaped are copied in bulk.
+     *
+     * @param[in] s
+     *     This is the input string.
+     *
+     * @param[in] spec
+     *     This specifies which characters to escape, and how.
+     *
+     * @param[out] output
+     *     This is where to write the escaped copy of the input string.
+     *     It must have room for EscapedLength characters.
+     */
+    void EscapeInto(std::string_view s, const StringUtils::EscapeSpec& spec, char* output) {
+        const auto& operations = StringUtils::Simd::GetBlockOperations();
+        const auto escapeCharacter = spec.GetEscapeCharacter();
+        size_t copied = 0;
+        StringUtils::Simd::ForEachBlock(
+            s, [&](const char* block) { return EscapeMask(operations, spec, block); },
+            [&](size_t blockBegin, uint64_t mask) {
+                while (mask != 0)
+                {
+                    const auto position = blockBegin + StringUtils::Simd::LowestBit(mask);
+                    (void)memcpy(output, s.data() + copied, position - copied);
+                    output += position - copied;
+                    *output++ = escapeCharacter;
+                    copied = position;
+                    mask &= mask - 1;
+                }
+            });
+        (void)memcpy(output, s.data() + copied, s.length() - copied);
+    }
+
+    /**
+     * This function writes a copy of the given input string to the given
+     * output, with the given escapeCharacter removed.  Any character
+     * following an escape character is kept as is, even if it's also an
+     * escape character.  Runs of characters between escape characters
+     * are copied in bulk.
+     *
+     * @param[in] s
+     *      This is the string from which to remove all escape characters.
+     *
+     * @param[in] escapeCharacter
+     *      This is the character to remove from the given input string.
+     *
+     * @param[out] output
+     *      This is where to write the unescaped copy of the input string.
+     *      It must have room for as many characters as the input, and
+     *      may be the same as the input.
+     *
+     * @return
+     *      The length of the unescaped copy is returned.
+     */
+    size_t UnescapeInto(std::string_view s, char escapeCharacter, char* output) {
+        const auto& operations = StringUtils::Simd::GetBlockOperations();
+        size_t copied = 0;
+        size_t written = 0;
+        StringUtils::Simd::ForEachBlock(
+            s, [&](const char* block) { return operations.equal(block, escapeCharacter); },
+            [&](size_t blockBegin, uint64_t mask) {
+                while (mask != 0)
+                {
+                    const auto position = blockBegin + StringUtils::Simd::LowestBit(mask);
+                    mask &= mask - 1;
+                    if (position < copied)
+                    { continue; }
+                    (void)memmove(output + written, s.data() + copied, position - copied);
+                    written += position - copied;
+                    copied = position + 1;
+                    if (copied < s.length())
+                    {
+                        output[written++] = s[copied];
+                        ++copied;
+                    }
+                }
+            });
+        (void)memmove(output + written, s.data() + copied, s.length() - copied);
+        return written + (s.length() - copied);
+    }
+
+    /**
+     * This is a word with every byte set to one.
+     */
+    constexpr uint64_t EveryByte = 0x0101010101010101;
+
+    /**
+     * This function loads up to eight characters into a word, padding
+     * it with zero bytes if there are fewer than eight.
+     *
+     * @param[in] characters
+     *      These are the characters to load.
+     *
+     * @param[in] length
+     *      This is the number of characters to load, at most eight.
+     *
+     * @return
+     *      The loaded word is returned.
+     */
+    uint64_t LoadWord(const char* characters, size_t length) {
+        uint64_t word = 0;
+        (void)memcpy(&word, characters, length);
+        return word;
+    }
+
+    /**
+     * This function converts each ASCII upper-case letter in the given
+     * word of eight characters to lower-case, all at once.
+     *
+     * @param[in] word
+     *      This is the word of characters to convert.
+     *
+     * @return
+     *      The converted word is returned.
+     */
+    uint64_t FoldAsciiCase(uint64_t word) {
+        const auto heptets = (word & (0x7f * EveryByte));
+        const auto atLeastA = heptets + ((0x80 - 'A') * EveryByte);
+        const auto afterZ = heptets + ((0x80 - 'Z' - 1) * EveryByte);
+        const auto upper = (atLeastA & ~afterZ & ~word & (0x80 * EveryByte));
+        return (word | (upper >> 2));
+    }
+
+    /**
+     * This function converts the given character to lower-case
+     * if it is an ASCII upper-case letter.
+     *
+     * @param[in] c
+     *      This is the character to convert.
+     *
+     * @return
+     *      The converted character is returned.
+     */
+    unsigned char FoldAsciiCase(char c) {
+        return (((c >= 'A') && (c <= 'Z')) ? (unsigned char)(c + ('a' - 'A')) : (unsigned char)c);
+    }
+
+    /**
+     * This function returns the value of the given character as a digit,
+     * or a value of at least 36 if it is not a digit in any base.
+     *
+     * @param[in] c
+     *     This is the character to convert.
+     *
+     * @return
+     *     The value of the character as a digit is returned.
+     */
+    int DigitValue(char c) {
+        if ((c >= '0') && (c <= '9'))
+        { return c - '0'; }
+        if ((c >= 'a') && (c <= 'z'))
+        { return c - 'a' + 10; }
+        if ((c >= 'A') && (c <= 'Z'))
+        { return c - 'A' + 10; }
+        return 36;
+    }
+
+    /**
+     * This function determines whether or not all eight characters
+     * in the given word are decimal digits.
+     *
+     * @param[in] word
+     *     This is the word of characters to check.
+     *
+     * @return
+     *     An indication of whether or not all characters in the word
+     *     are decimal digits is returned.
+     */
+    bool IsEightDigits(uint64_t word) {
+        const auto highNybbles = (0xf0 * EveryByte);
+        return (((word & highNybbles) | (((word + (0x06 * EveryByte)) & highNybbles) >> 4))
+                == (0x33 * EveryByte));
+    }
+
+    /**
+     * This function returns the value of the eight decimal digits in the
+     * given word, the first character of which is in the lowest byte,
+     * combining them pairwise, then in fours, with three multiplications.
+     *
+     * @param[in] word
+     *     This is the word of digits to convert.
+     *
+     * @return
+     *     The value of the digits is returned.
+     */
+    uint64_t ParseEightDigits(uint64_t word) {
+        constexpr uint64_t pairs = 0x000000ff000000ff;
+        word -= '0' * EveryByte;
+        word = (word * 10) + (word >> 8);
+        return ((((word & pairs) * (100 + (1000000ull << 32)))
+                 + (((word >> 16) & pairs) * (1 + (10000ull << 32))))
+                >> 32);
+    }
+
+    /**
+     * This function parses the integer at the beginning of the given
+     * string, for ToIntegerPrefix, as a sign and a magnitude.
+     *
+     * @param[in] numberString
+     *     This is the string beginning with the number to parse.
+     *
+     * @param[in] base
+     *     This is the base of the number.
+     *
+     * @param[in] allowNegative
+     *     This indicates whether or not a minus sign is permitted.
+     *
+     * @param[in] positiveLimit
+     *     This is the largest magnitude permitted for positive numbers.
+     *
+     * @param[in] negativeLimit
+     *     This is the largest magnitude permitted for negative numbers.
+     *
+     * @param[out] negative
+     *     This is where to store whether or not the number is negative.
+     *
+     * @param[out] magnitude
+     *     This is where to store the magnitude of the number.
+     *
+     * @param[out] consumed
+     *     This is where to store the number of characters parsed.
+     *
+     * @return
+     *     An indication of whether or not the number was parsed
+     *     successfully is returned.
+     */
+    StringUtils::ToIntegerResult ParseMagnitude(std::string_view numberString, int base,
+                                                bool allowNegative, uint64_t positiveLimit,
+                                                uint64_t negativeLimit, bool& negative,
+                                                uint64_t& magnitude, size_t& consumed) {
+        consumed = 0;
+        if ((base < 2) || (base > 36))
+        { return StringUtils::ToIntegerResult::NotANumber; }
+        size_t index = 0;
+        negative = false;
+        if ((index < numberString.length()) && (numberString[index] == '-'))
+        {
+            if (!allowNegative)
+            { return StringUtils::ToIntegerResult::NotANumber; }
+            negative = true;
+            ++index;
+        }
+        if ((index >= numberString.length()) || (DigitValue(numberString[index]) >= base))
+        { return StringUtils::ToIntegerResult::NotANumber; }
+        if (numberString[index] == '0')
+        {
+            ++index;
+            if ((index < numberString.length()) && (DigitValue(numberString[index]) < base))
+            { return StringUtils::ToIntegerResult::NotANumber; }
+            magnitude = 0;
+            consumed = index;
+            return StringUtils::ToIntegerResult::Success;
+        }
+        const auto limit = (negative ? negativeLimit : positiveLimit);
+        uint64_t value = 0;
+        bool overflow = false;
+#if !defined(__BYTE_ORDER__) || (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+        if (base == 10)
+        {
+            // Nineteen decimal digits always fit in 64 bits, so
+            // no overflow check is needed until the end of each group.
+            size_t digits = 0;
+            while ((index + 8 <= numberString.length()) && (digits + 8 <= 19))
+            {
+                const auto word = LoadWord(numberString.data() + index, 8);
+                if (!IsEightDigits(word))
+                { break; }
+                value = value * 100000000 + ParseEightDigits(word);
+                index += 8;
+                digits += 8;
+            }
+            overflow = (value > limit);
+        }
+#endif
+        const auto cutoff = limit / (uint64_t)base;
+        const auto cutoffDigit = (int)(limit % (uint64_t)base);
+        for (; index < numberString.length(); ++index)
+        {
+            const auto digit = DigitValue(numberString[index]);
+            if (digit >= base)
+            { break; }
+            if ((value > cutoff) || ((value == cutoff) && (digit > cutoffDigit)))
+            { overflow = true; }
+            if (!overflow)
+            { value = value * (uint64_t)base + (uint64_t)digit; }
+        }
+        consumed = index;
+        if (overflow)
+        { return StringUtils::ToIntegerResult::Overflow; }
+        magnitude = value;
+        return StringUtils::ToIntegerResult::Success;
+    }
+
+    /**
+     * This holds the pieces of a number in decimal notation,
+     * as scanned by ScanDecimal.
+     */
+    struct DecimalNumber
+    {
+        /**
+         * This indicates whether or not the number is negative.
+         */
+        bool negative = false;
+
+        /**
+         * These are the first (up to 19) significant digits of the number.
+         */
+        uint64_t mantissa = 0;
+
+        /**
+         * This is the power of ten by which to multiply the mantissa.
+         */
+        int64_t exponent = 0;
+
+        /**
+         * This indicates whether or not there were more significant
+         * digits than would fit in the mantissa.
+         */
+        bool truncated = false;
+    };
+
+    /**
+     * This function checks that the given string is a number in decimal
+     * notation, as accepted by ToDouble, and breaks it into pieces.
+     *
+     * @param[in] numberString
+     *     This is the string to scan.
+     *
+     * @param[out] number
+     *     This is where to store the pieces of the number.
+     *
+     * @return
+     *     An indication of whether or not the string is a number
+     *     in decimal notation is returned.
+     */
+    bool ScanDecimal(std::string_view numberString, DecimalNumber& number) {
+        size_t index = 0;
+        const auto length = numberString.length();
+        if ((index < length) && (numberString[index] == '-'))
+        {
+            number.negative = true;
+            ++index;
+        }
+        size_t significantDigits = 0;
+        bool anyDigits = false;
+        bool inFraction = false;
+        for (; index < length; ++index)
+        {
+            const auto c = numberString[index];
+            if (c == '.')
+            {
+                if (inFraction)
+                { return false; }
+                inFraction = true;
+                continue;
+            }
+            if ((c < '0') || (c > '9'))
+            { break; }
+            anyDigits = true;
+            if ((significantDigits == 0) && (c == '0'))
+            {
+                if (inFraction)
+                { --number.exponent; }
+                continue;
+            }
+            if (significantDigits < 19)
+            {
+                number.mantissa = number.mantissa * 10 + (uint64_t)(c - '0');
+                ++significantDigits;
+                if (inFraction)
+                { --number.exponent; }
+            } else
+            {
+                if (c != '0')
+                { number.truncated = true; }
+                if (!inFraction)
+                { ++number.exponent; }
+            }
+        }
+        if (!anyDigits)
+        { return false; }
+        if ((index < length) && ((numberString[index] == 'e') || (numberString[index] == 'E')))
+        {
+            ++index;
+            bool negativeExponent = false;
+            if ((index < length) && ((numberString[index] == '-') || (numberString[index] == '+')))
+            {
+                negativeExponent = (numberString[index] == '-');
+                ++index;
+            }
+            if ((index >= length) || (numberString[index] < '0') || (numberString[index] > '9'))
+            { return false; }
+            int64_t exponent = 0;
+            for (; (index < length) && (numberString[index] >= '0') && (numberString[index] <= '9');
+                 ++index)
+            {
+                // Clamp absurd exponents, which overflow or underflow
+                // regardless of the mantissa.
+                if (exponent < 100000)
+                { exponent = exponent * 10 + (numberString[index] - '0'); }
+            }
+            number.exponent += (negativeExponent ? -exponent : exponent);
+        }
+        if (number.mantissa == 0)
+        { number.exponent = 0; }
+        return (index == length);
+    }
+
+    /**
+     * This function counts the decimal digits of the given number.
+     */
+    int64_t CountDigits(uint64_t value) {
+        int64_t digits = 0;
+        while (value != 0)
+        {
+            value /= 10;
+            ++digits;
+        }
+        return digits;
+    }
+
+    /**
+     * These are the powers of ten which are exactly representable
+     * as double-precision floating-point numbers.
+     */
+    constexpr double ExactPowersOfTen[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+
+    /**
+     * This function parses the given string as a floating-point number of
+     * the given type, for ToDouble and ToFloat.
+     *
+     * When the significant digits and the power of ten are both exactly
+     * representable in the type, a single multiplication or division
+     * produces the correctly rounded result (Clinger's fast path).  This
+     * covers the vast majority of numbers seen in practice, such as
+     * measurements written with a handful of decimal places.  All other
+     * numbers are handed to std::from_chars, which is also exact.
+     *
+     * @param[in] numberString
+     *     This is the string containing the number to parse.
+     *
+     * @param[out] number
+     *     This is where to store the number parsed.
+     *
+     * @return
+     *     An indication of whether or not the number was parsed
+     *     successfully is returned.
+     */
+    template <typename Real>
+    StringUtils::ToDoubleResult ParseReal(std::string_view numberString, Real& number) {
+        DecimalNumber decimal;
+        if (!ScanDecimal(numberString, decimal))
+        { return StringUtils::ToDoubleResult::NotANumber; }
+        if (decimal.mantissa == 0)
+        {
+            number = (decimal.negative ? -(Real)0 : (Real)0);
+            return StringUtils::ToDoubleResult::Success;
+        }
+#if FLT_EVAL_METHOD == 0
+        constexpr uint64_t maxExactMantissa = (uint64_t)1 << std::numeric_limits<Real>::digits;
+        constexpr int64_t maxExactPower = (std::is_same<Real, float>::value ? 10 : 22);
+        if (!decimal.truncated && (decimal.mantissa <= maxExactMantissa)
+            && (decimal.exponent >= -maxExactPower) && (decimal.exponent <= maxExactPower))
+        {
+            auto value = (Real)decimal.mantissa;
+            if (decimal.exponent < 0)
+            {
+                value /= (Real)ExactPowersOfTen[-decimal.exponent];
+            } else
+            { value *= (Real)ExactPowersOfTen[decimal.exponent]; }
+            number = (decimal.negative ? -value : value);
+            return StringUtils::ToDoubleResult::Success;
+        }
+#endif
+        Real value;
+        const auto end = numberString.data() + numberString.length();
+        const auto result = std::from_chars(numberString.data(), end, value);
+        if (result.ec == std::errc::result_out_of_range)
+        {
+            if (decimal.exponent + CountDigits(decimal.mantissa) > 0)
+            {
+                return StringUtils::ToDoubleResult::Overflow;
+            } else
+            { return StringUtils::ToDoubleResult::Underflow; }
+        }
+        if ((result.ec != std::errc()) || (result.ptr != end))
+        { return StringUtils::ToDoubleResult::NotANumber; }
+        number = value;
+        return StringUtils::ToDoubleResult::Success;
+    }
+
+    /**
+     * This function parses one field for ParseColumns as an integer.
+     *
+     * @param[in] field
+     *     This is the field to parse, with whitespace trimmed.
+     *
+     * @param[out] value
+     *     This is where to store the value parsed.
+     *
+     * @param[out] kind
+     *     This is where to store what was wrong with the field, if anything.
+     *
+     * @return
+     *     An indication of whether or not the field was parsed
+     *     successfully is returned.
+     */
+    bool ParseField(std::string_view field, int64_t& value, StringUtils::FieldErrorKind& kind) {
+        switch (StringUtils::ToInteger(field, value))
+        {
+        case StringUtils::ToIntegerResult::Success:
+            return true;
+        case StringUtils::ToIntegerResult::Overflow:
+            kind = StringUtils::FieldErrorKind::Overflow;
+            return false;
+        default:
+            kind = StringUtils::FieldErrorKind::NotANumber;
+            return false;
+        }
+    }
+
+    /**
+     * This function parses one field for ParseColumns as a
+     * floating-point number.
+     *
+     * @param[in] field
+     *     This is the field to parse, with whitespace trimmed.
+     *
+     * @param[out] value
+     *     This is where to store the value parsed.
+     *
+     * @param[out] kind
+     *     This is where to store what was wrong with the field, if anything.
+     *
+     * @return
+     *     An indication of whether or not the field was parsed
+     *     successfully is returned.
+     */
+    bool ParseField(std::string_view field, double& value, StringUtils::FieldErrorKind& kind) {
+        switch (StringUtils::ToDouble(field, value))
+        {
+        case StringUtils::ToDoubleResult::Success:
+            return true;
+        case StringUtils::ToDoubleResult::Overflow:
+            kind = StringUtils::FieldErrorKind::Overflow;
+            return false;
+        case StringUtils::ToDoubleResult::Underflow:
+            kind = StringUtils::FieldErrorKind::Underflow;
+            return false;
+        default:
+            kind = StringUtils::FieldErrorKind::NotANumber;
+            return false;
+        }
+    }
+
+    /**
+     * These are the characters which can affect where a component ends.
+     */
+    constexpr char ComponentStructuralCharacters[] = {
+        ',', '"', '\\', '[', '{', '(', '<', ']', '}', ')', '>',
+    };
+
+    /**
+     * This function marks the characters of the given block which
+     * can affect where a component ends.
+     *
+     * @param[in] operations
+     *     These are the block operations to use.
+     *
+     * @param[in] block
+     *     This is the block of characters to classify.
+     *
+     * @return
+     *     A mask marking the structural characters is returned.
+     */
+    uint64_t ComponentStructureMask(const StringUtils::Simd::BlockOperations& operations,
+                                    const char* block) {
+        uint64_t mask = 0;
+        for (auto c : ComponentStructuralCharacters)
+        { mask |= operations.equal(block, c); }
+        return mask;
+    }
+
+    /**
+     * This holds the decimal digits of every number from 00 to 99,
+     * so that integers can be converted two digits at a time.
+     */
+    constexpr char DigitPairs[] = (
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899"
+    );
+
+    /**
+     * This function appends the given integer, in decimal, to the given
+     * builder, converting two digits at a time.
+     *
+     * @param[in,out] output
+     *     This is the builder to which to append the integer.
+     *
+     * @param[in] value
+     *     This is the integer to append, or its two's complement
+     *     if it's negative.
+     *
+     * @param[in] negative
+     *     This indicates whether or not the integer is negative.
+     */
+    void AppendDecimal(StringUtils::StringBuilder& output, uintmax_t value, bool negative) {
+        char digits[std::numeric_limits<uintmax_t>::digits10 + 2];
+        auto end = digits + sizeof(digits);
+        auto begin = end;
+        if (negative)
+        { value = 0 - value; }
+        while (value >= 100)
+        {
+            const auto pair = (size_t)(value % 100) * 2;
+            value /= 100;
+            *--begin = DigitPairs[pair + 1];
+            *--begin = DigitPairs[pair];
+        }
+        if (value >= 10)
+        {
+            *--begin = DigitPairs[value * 2 + 1];
+            *--begin = DigitPairs[value * 2];
+        } else
+        { *--begin = (char)('0' + value); }
+        if (negative)
+        { *--begin = '-'; }
+        output.Append(std::string_view(begin, (size_t)(end - begin)));
+    }
+
+    /**
+     * This function appends the given floating-point number to the given
+     * builder, in the shortest form which reads back as the same number.
+     *
+     * @param[in,out] output
+     *     This is the builder to which to append the number.
+     *
+     * @param[in] value
+     *     This is the number to append.
+     */
+    template <typename Real>
+    void AppendShortest(StringUtils::StringBuilder& output, Real value) {
+        char buffer[64];
+        const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        output.Append(std::string_view(buffer, (size_t)(result.ptr - buffer)));
+    }
+
+    /**
+     * This is the number of characters at each end of a string checked
+     * one at a time for whitespace, before checking a block at a time.
+     * Most strings have little or no whitespace to trim.
+     */
+    constexpr size_t TrimScalarPrefix = 8;
+
+    /**
+     * This function determines whether or not the given character
+     * is in the given whitespace class.
+     *
+     * @param[in] c
+     *      This is the character to check.
+     *
+     * @param[in] whitespace
+     *      This is the set of characters to consider whitespace.
+     *
+     * @return
+     *      An indication of whether or not the given character
+     *      is whitespace is returned.
+     */
+    bool IsWhitespace(char c, StringUtils::WhitespaceClass whitespace) {
+        if (whitespace == StringUtils::WhitespaceClass::Control)
+        {
+            return IsTrimWhitespace(c);
+        } else
+        { return (c == ' ') || ((c >= '\t') && (c <= '\r')); }
+    }
+
+    /**
+     * This function marks the characters of the given block which
+     * are in the given whitespace class.
+     *
+     * @param[in] operations
+     *     These are the block operations to use.
+     *
+     * @param[in] whitespace
+     *      This is the set of characters to consider whitespace.
+     *
+     * @param[in] block
+     *     This is the block of characters to classify.
+     *
+     * @return
+     *     A mask marking the whitespace characters is returned.
+     */
+    uint64_t WhitespaceMask(const StringUtils::Simd::BlockOperations& operations,
+                            StringUtils::WhitespaceClass whitespace, const char* block) {
+        if (whitespace == StringUtils::WhitespaceClass::Control)
+        { return operations.trimWhitespace(block); }
+        uint64_t mask = 0;
+        for (auto c : {' ', '\t', '\n', '\v', '\f', '\r'})
+        { mask |= operations.equal(block, c); }
+        return mask;
+    }
+
+    /**
+     * This function returns the offset of the first character in the
+     * given string which is not whitespace.
+     *
+     * @param[in] s
+     *      This is the string to scan.
+     *
+     * @param[in] whitespace
+     *      This is the set of characters to consider whitespace.
+     *
+     * @return
+     *      The offset of the first character which is not whitespace is
+     *      returned, or the length of the string if there is none.
+     */
+    size_t SkipLeadingWhitespace(std::string_view s, StringUtils::WhitespaceClass whitespace) {
+        size_t i = 0;
+        for (; (i < s.length()) && (i < TrimScalarPrefix); ++i)
+        {
+            if (!IsWhitespace(s[i], whitespace))
+            { return i; }
+        }
+        const auto& operations = StringUtils::Simd::GetBlockOperations();
+        for (; i + StringUtils::Simd::BlockSize <= s.length(); i += StringUtils::Simd::BlockSize)
+        {
+            const auto content = ~WhitespaceMask(operations, whitespace, s.data() + i);
+            if (content != 0)
+            { return i + StringUtils::Simd::LowestBit(content); }
+        }
+        while ((i < s.length()) && IsWhitespace(s[i], whitespace))
+        { ++i; }
+        return i;
+    }
+
+    /**
+     * This function returns the offset just past the last character in
+     * the given string which is not whitespace, not looking before the
+     * given offset.
+     *
+     * @param[in] s
+     *      This is the string to scan.
+     *
+     * @param[in] begin
+     *      This is the offset of the first character to consider.
+     *
+     * @param[in] whitespace
+     *      This is the set of characters to consider whitespace.
+     *
+     * @return
+     *      The offset just past the last character which is not
+     *      whitespace is returned, or the given beginning offset
+     *      if there is none.
+     */
+    size_t SkipTrailingWhitespace(std::string_view s, size_t begin,
+                                  StringUtils::WhitespaceClass whitespace) {
+        auto j = s.length();
+        for (; (j > begin) && (s.length() - j < TrimScalarPrefix); --j)
+        {
+            if (!IsWhitespace(s[j - 1], whitespace))
+            { return j; }
+        }
+        const auto& operations = StringUtils::Simd::GetBlockOperations();
+        for (; j - begin >= StringUtils::Simd::BlockSize; j -= StringUtils::Simd::BlockSize)
+        {
+            const auto blockBegin = j - StringUtils::Simd::BlockSize;
+            const auto content = ~WhitespaceMask(operations, whitespace, s.data() + blockBegin);
+            if (content != 0)
+            { return blockBegin + StringUtils::Simd::HighestBit(content) + 1; }
+        }
+        while ((j > begin) && IsWhitespace(s[j - 1], whitespace))
+        { --j; }
+        return j;
+    }
+
+    /**
+     * This function is the same as TrimView, except that the call isn't
+     * recorded by the instrumentation, for the functions which trim each
+     * piece they find as part of their own work.
+     *
+     * @param[in] s
+     *      This is the string to trim.
+     *
+     * @param[in] whitespace
+     *      This is the set of characters to consider whitespace.
+     *
+     * @return
+     *      A view of the string without leading or trailing whitespace
+     *      is returned.
+     */
+    std::string_view TrimPiece(
+        std::string_view s,
+        StringUtils::WhitespaceClass whitespace = StringUtils::WhitespaceClass::Control
+    ) {
+        const auto begin = SkipLeadingWhitespace(s, whitespace);
+        const auto end = SkipTrailingWhitespace(s, begin, whitespace);
+        return s.substr(begin, end - begin);
+    }
+
+    /**
+     * This function decodes the UTF-8 sequence at the given offset of
+     * the given text, following the well-formedness rules of the Unicode
+     * standard (no overlong forms, surrogates or values past U+10FFFF).
+     *
+     * @param[in] utf8
+     *     This is the text to decode.
+     *
+     * @param[in,out] offset
+     *     This is the offset of the sequence to decode, which is moved
+     *     past it if it's valid.
+     *
+     * @param[out] codePoint
+     *     This is where to store the code point decoded.
+     *
+     * @return
+     *     An indication of whether or not the sequence is valid
+     *     is returned.
+     */
+    StringUtils::UtfResult DecodeUtf8Sequence(std::string_view utf8, size_t& offset,
+                                              char32_t& codePoint) {
+        const auto lead = (unsigned char)utf8[offset];
+        size_t length;
+        unsigned char low = 0x80;
+        unsigned char high = 0xbf;
+        if (lead < 0x80)
+        {
+            codePoint = lead;
+            ++offset;
+            return StringUtils::UtfResult::Success;
+        } else if ((lead >= 0xc2) && (lead <= 0xdf))
+        {
+            length = 2;
+            codePoint = lead & 0x1f;
+        } else if ((lead >= 0xe0) && (lead <= 0xef))
+        {
+            length = 3;
+            codePoint = lead & 0x0f;
+            if (lead == 0xe0)
+            {
+                low = 0xa0;
+            } else if (lead == 0xed)
+            { high = 0x9f; }
+        } else if ((lead >= 0xf0) && (lead <= 0xf4))
+        {
+            length = 4;
+            codePoint = lead & 0x07;
+            if (lead == 0xf0)
+            {
+                low = 0x90;
+            } else if (lead == 0xf4)
+            { high = 0x8f; }
+        } else
+        { return StringUtils::UtfResult::InvalidSequence; }
+        for (size_t i = 1; i < length; ++i)
+        {
+            if (offset + i >= utf8.length())
+            { return StringUtils::UtfResult::Truncated; }
+            const auto continuation = (unsigned char)utf8[offset + i];
+            if ((continuation < low) || (continuation > high))
+            { return StringUtils::UtfResult::InvalidSequence; }
+            low = 0x80;
+            high = 0xbf;
+            codePoint = (codePoint << 6) | (continuation & 0x3f);
+        }
+        offset += length;
+        return StringUtils::UtfResult::Success;
+    }
+
+    /**
+     * This function returns the number of leading code units of the given
+     * text which are ASCII, checking four (UTF-16) or two (UTF-32) units
+     * at a time.
+     *
+     * @param[in] units
+     *     These are the code units of the text.
+     *
+     * @param[in] length
+     *     This is the number of code units in the text.
+     *
+     * @return
+     *     The number of leading ASCII code units is returned.
+     */
+    template <typename Unit>
+    size_t AsciiPrefixLength(const Unit* units, size_t length) {
+        constexpr size_t unitsPerWord = sizeof(uint64_t) / sizeof(Unit);
+        constexpr uint64_t nonAsciiBits = (sizeof(Unit) == 2) ? 0xff80ff80ff80ff80
+                                                              : 0xffffff80ffffff80;
+        size_t i = 0;
+        for (; i + unitsPerWord <= length; i += unitsPerWord)
+        {
+            uint64_t word;
+            (void)memcpy(&word, units + i, sizeof(word));
+            if ((word & nonAsciiBits) != 0)
+            { break; }
+        }
+        while ((i < length) && ((uint32_t)units[i] < 0x80))
+        { ++i; }
+        return i;
+    }
+
+    /**
+     * This function decodes the given UTF-8 text, handing runs of ASCII
+     * characters, and other code points, to the given sink.  Blocks of
+     * ASCII characters are detected a block at a time.
+     *
+     * @param[in] units
+     *     These are the code units of the text.
+     *
+     * @param[in] length
+     *     This is the number of code units in the text.
+     *
+     * @param[in,out] sink
+     *     This is what to hand the characters decoded.
+     *
+     * @param[out] errorOffset
+     *     This is where to store the offset of the sequence which is not
+     *     valid, or the length of the text if it's all valid.
+     *
+     * @return
+     *     An indication of whether or not the text is valid is returned.
+     */
+    template <typename Sink>
+    StringUtils::UtfResult DecodeUtf8(const char* units, size_t length, Sink& sink,
+                                      size_t& errorOffset) {
+        const std::string_view utf8(units, length);
+        const auto& operations = StringUtils::Simd::GetBlockOperations();
+        size_t i = 0;
+        while (i < length)
+        {
+            size_t blockEnd = length;
+            if (i + StringUtils::Simd::BlockSize <= length)
+            {
+                if (operations.nonAscii(units + i) == 0)
+                {
+                    sink.Ascii(units + i, StringUtils::Simd::BlockSize);
+                    i += StringUtils::Simd::BlockSize;
+                    continue;
+                }
+                blockEnd = i + StringUtils::Simd::BlockSize;
+            }
+            while (i < blockEnd)
+            {
+                auto run = i;
+                while ((run < blockEnd) && ((unsigned char)units[run] < 0x80))
+                { ++run; }
+                if (run > i)
+                {
+                    sink.Ascii(units + i, run - i);
+                    i = run;
+                    continue;
+                }
+                char32_t codePoint;
+                const auto result = DecodeUtf8Sequence(utf8, i, codePoint);
+                if (result != StringUtils::UtfResult::Success)
+                {
+                    errorOffset = i;
+                    return result;
+                }
+                sink.CodePoint(codePoint);
+            }
+        }
+        errorOffset = length;
+        return StringUtils::UtfResult::Success;
+    }
+
+    /**
+     * This function decodes the given UTF-16 text, in the same
+     * way as DecodeUtf8.
+     */
+    template <typename Unit, typename Sink>
+    StringUtils::UtfResult DecodeUtf16(const Unit* units, size_t length, Sink& sink,
+                                       size_t& errorOffset) {
+        size_t i = 0;
+        while (i < length)
+        {
+            const auto run = AsciiPrefixLength(units + i, length - i);
+            if (run > 0)
+            {
+                sink.Ascii(units + i, run);
+                i += run;
+                continue;
+            }
+            const auto unit = (char32_t)(uint16_t)units[i];
+            if ((unit >= 0xd800) && (unit <= 0xdbff))
+            {
+                if (i + 1 >= length)
+                {
+                    errorOffset = i;
+                    return StringUtils::UtfResult::Truncated;
+                }
+                const auto next = (char32_t)(uint16_t)units[i + 1];
+                if ((next < 0xdc00) || (next > 0xdfff))
+                {
+                    errorOffset = i;
+                    return StringUtils::UtfResult::InvalidSequence;
+                }
+                sink.CodePoint(0x10000 + ((unit - 0xd800) << 10) + (next - 0xdc00));
+                i += 2;
+            } else if ((unit >= 0xdc00) && (unit <= 0xdfff))
+            {
+                errorOffset = i;
+                return StringUtils::UtfResult::InvalidSequence;
+            } else
+            {
+                sink.CodePoint(unit);
+                ++i;
+            }
+        }
+        errorOffset = length;
+        return StringUtils::UtfResult::Success;
+    }
+
+    /**
+     * This function decodes the given UTF-32 text, in the same
+     * way as DecodeUtf8.
+     */
+    template <typename Unit, typename Sink>
+    StringUtils::UtfResult DecodeUtf32(const Unit* units, size_t length, Sink& sink,
+                                       size_t& errorOffset) {
+        size_t i = 0;
+        while (i < length)
+        {
+            const auto run = AsciiPrefixLength(units + i, length - i);
+            if (run > 0)
+            {
+                sink.Ascii(units + i, run);
+                i += run;
+                continue;
+            }
+            const auto codePoint = (char32_t)(uint32_t)units[i];
+            if ((codePoint > 0x10ffff) || ((codePoint >= 0xd800) && (codePoint <= 0xdfff)))
+            {
+                errorOffset = i;
+                return StringUtils::UtfResult::InvalidSequence;
+            }
+            sink.CodePoint(codePoint);
+            ++i;
+        }
+        errorOffset = length;
+        return StringUtils::UtfResult::Success;
+    }
+
+    /**
+     * This function decodes the given text, whose encoding is given by
+     * the size of its code units, in the same way as DecodeUtf8.
+     */
+    template <typename Unit, typename Sink>
+    StringUtils::UtfResult DecodeUtf(const Unit* units, size_t length, Sink& sink,
+                                     size_t& errorOffset) {
+        if constexpr (sizeof(Unit) == 1)
+        {
+            return DecodeUtf8((const char*)units, length, sink, errorOffset);
+        } else if constexpr (sizeof(Unit) == 2)
+        {
+            return DecodeUtf16(units, length, sink, errorOffset);
+        } else
+        { return DecodeUtf32(units, length, sink, errorOffset); }
+    }
+
+    /**
+     * This is a decoding sink which ignores everything, for validation.
+     */
+    struct IgnoringSink
+    {
+        template <typename Unit>
+        void Ascii(const Unit*, size_t) {}
+
+        void CodePoint(char32_t) {}
+    };
+
+    /**
+     * This is a decoding sink which counts the code units needed to
+     * encode the characters decoded, in the encoding given by the size
+     * of the code units.
+     */
+    template <typename OutputUnit>
+    struct CountingSink
+    {
+        size_t length = 0;
+
+        template <typename Unit>
+        void Ascii(const Unit*, size_t count) {
+            length += count;
+        }
+
+        void CodePoint(char32_t codePoint) {
+            if (sizeof(OutputUnit) == 1)
+            {
+                length += ((codePoint < 0x80) ? 1
+                           : (codePoint < 0x800) ? 2
+                           : (codePoint < 0x10000) ? 3
+                                                   : 4);
+            } else if (sizeof(OutputUnit) == 2)
+            {
+                length += ((codePoint < 0x10000) ? 1 : 2);
+            } else
+            { ++length; }
+        }
+    };
+
+    /**
+     * This is a decoding sink which encodes the characters decoded, in the
+     * encoding given by the size of the code units, into a buffer.
+     */
+    template <typename OutputUnit>
+    struct EncodingSink
+    {
+        OutputUnit* output;
+
+        template <typename Unit>
+        void Ascii(const Unit* units, size_t count) {
+            for (size_t i = 0; i < count; ++i)
+            { output[i] = (OutputUnit)units[i]; }
+            output += count;
+        }
+
+        void CodePoint(char32_t codePoint) {
+            if (sizeof(OutputUnit) == 1)
+            {
+                if (codePoint < 0x80)
+                {
+                    *output++ = (OutputUnit)codePoint;
+                } else if (codePoint < 0x800)
+                {
+                    *output++ = (OutputUnit)(0xc0 | (codePoint >> 6));
+                    *output++ = (OutputUnit)(0x80 | (codePoint & 0x3f));
+                } else if (codePoint < 0x10000)
+                {
+                    *output++ = (OutputUnit)(0xe0 | (codePoint >> 12));
+                    *output++ = (OutputUnit)(0x80 | ((codePoint >> 6) & 0x3f));
+                    *output++ = (OutputUnit)(0x80 | (codePoint & 0x3f));
+                } else
+                {
+                    *output++ = (OutputUnit)(0xf0 | (codePoint >> 18));
+                    *output++ = (OutputUnit)(0x80 | ((codePoint >> 12) & 0x3f));
+                    *output++ = (OutputUnit)(0x80 | ((codePoint >> 6) & 0x3f));
+                    *output++ = (OutputUnit)(0x80 | (codePoint & 0x3f));
+                }
+            } else if ((sizeof(OutputUnit) == 2) && (codePoint >= 0x10000))
+            {
+                *output++ = (OutputUnit)(0xd800 + ((codePoint - 0x10000) >> 10));
+                *output++ = (OutputUnit)(0xdc00 + ((codePoint - 0x10000) & 0x3ff));
+            } else
+            { *output++ = (OutputUnit)codePoint; }
+        }
+    };
+
+    /**
+     * This function converts the given text from one Unicode encoding
+     * to another, each given by the size of its code units.  The text is
+     * decoded twice: once to check it and measure the result, and once
+     * to encode the result.
+     *
+     * @param[in] units
+     *     These are the code units of the text.
+     *
+     * @param[in] length
+     *     This is the number of code units in the text.
+     *
+     * @param[out] output
+     *     This is where to store the converted text.
+     *
+     * @param[out] errorOffset
+     *     This is where to store the offset of the sequence which is not
+     *     valid, or the length of the text if it's all valid.
+     *
+     * @return
+     *     An indication of whether or not the text was converted
+     *     is returned.
+     */
+    template <typename Unit, typename String>
+    StringUtils::UtfResult Transcode(const Unit* units, size_t length, String& output,
+                                     size_t& errorOffset) {
+        using OutputUnit = typename String::value_type;
+        CountingSink<OutputUnit> counter;
+        const auto result = DecodeUtf(units, length, counter, errorOffset);
+        if (result != StringUtils::UtfResult::Success)
+        { return result; }
+        output.assign(counter.length, OutputUnit());
+        EncodingSink<OutputUnit> encoder{&output[0]};
+        return DecodeUtf(units, length, encoder, errorOffset);
+    }
+}  // namespace
 
 namespace StringUtils
 {
     std::string sprintf(const char* format, ...) {
         va_list args;
         va_start(args, format);
-        return vsprintf(format, args);
+        auto result = vsprintf(format, args);
+        va_end(args);
+        return result;
     }
 
     std::string vsprintf(const char* format, va_list args) {
+        STRING_UTILS_PROBE(sprintf, strlen(format));
+        // Most strings fit on the stack, so they're formatted only once,
+        // and copied straight into the result.
+        char stackBuffer[256];
         va_list argsCopy;
         va_copy(argsCopy, args);
-        const int required = vsnprintf(nullptr, 0, format, args);
-        va_end(args);
+        const int required = vsnprintf(stackBuffer, sizeof(stackBuffer), format, argsCopy);
+        va_end(argsCopy);
         if (required < 0)
-        {
-            va_end(argsCopy);
-            return "";
-        }
-        std::vector<char> buffer(required + 1);
-        const int result = vsnprintf(&buffer[0], required + 1, format, argsCopy);
+        { return ""; }
+        STRING_UTILS_PROBE_OUTPUT(required);
+        if ((size_t)required < sizeof(stackBuffer))
+        { return std::string(stackBuffer, (size_t)required); }
+        std::string result((size_t)required, '\0');
+        va_copy(argsCopy, args);
+        const int written = vsnprintf(&result[0], (size_t)required + 1, format, argsCopy);
         va_end(argsCopy);
-        if (result < 0)
+        if (written < 0)
         { return ""; }
-        return std::string(buffer.begin(), buffer.begin() + required);
+        return result;
+    }
+
+    void FormatArgument::AppendTo(StringBuilder& output) const {
+        switch (type)
+        {
+        case Type::Boolean:
+            output.Append(boolean ? "true" : "false");
+            break;
+        case Type::Character:
+            output.Append(character);
+            break;
+        case Type::SignedInteger:
+            AppendDecimal(output, (uintmax_t)signedInteger, (signedInteger < 0));
+            break;
+        case Type::UnsignedInteger:
+            AppendDecimal(output, unsignedInteger, false);
+            break;
+        case Type::Float:
+            AppendShortest(output, singlePrecision);
+            break;
+        case Type::Double:
+            AppendShortest(output, doublePrecision);
+            break;
+        case Type::String:
+            output.Append(std::string_view(string.data, string.length));
+            break;
+        }
+    }
+
+    std::string FormatArguments(std::string_view format, const FormatArgument* arguments,
+                                size_t count) {
+        StringBuilder output;
+        output.Reserve(format.length() + count * 16);
+        size_t next = 0;
+        size_t copied = 0;
+        for (size_t i = 0; i + 1 < format.length(); ++i)
+        {
+            const auto c = format[i];
+            if ((c != '{') && (c != '}'))
+            { continue; }
+            const auto following = format[i + 1];
+            if ((c == '{') && (following == '}'))
+            {
+                if (next >= count)
+                {
+                    ++i;
+                    continue;
+                }
+                output.Append(format.substr(copied, i - copied));
+                arguments[next++].AppendTo(output);
+            } else if (following == c)
+            {
+                output.Append(format.substr(copied, i + 1 - copied));
+            } else
+            { continue; }
+            ++i;
+            copied = i + 1;
+        }
+        output.Append(format.substr(copied));
+        return output.Finish();
     }
 
     std::string wcstombs(const std::wstring& src) {
@@ -40,39 +1886,97 @@ namespace StringUtils
         return std::string(&buffer[0]);
     }
 
-    std::string Trim(const std::string& s) {
-        size_t i = 0;
-        while ((i < s.length()) && s[i] <= 32)
-        { ++i; }
-        size_t j = s.length();
-        while ((j > 0) && (s[j - 1] <= 32))
-        { --j; }
-        return s.substr(i, j - i);
+    UtfResult ValidateUtf8(std::string_view utf8, size_t& errorOffset) {
+        IgnoringSink sink;
+        return DecodeUtf8(utf8.data(), utf8.length(), sink, errorOffset);
+    }
+
+    bool IsValidUtf8(std::string_view utf8) {
+        size_t errorOffset;
+        return (ValidateUtf8(utf8, errorOffset) == UtfResult::Success);
+    }
+
+    UtfResult Utf8ToUtf16(std::string_view utf8, std::u16string& utf16, size_t& errorOffset) {
+        return Transcode(utf8.data(), utf8.length(), utf16, errorOffset);
+    }
+
+    UtfResult Utf8ToUtf32(std::string_view utf8, std::u32string& utf32, size_t& errorOffset) {
+        return Transcode(utf8.data(), utf8.length(), utf32, errorOffset);
+    }
+
+    UtfResult Utf8ToWide(std::string_view utf8, std::wstring& wide, size_t& errorOffset) {
+        return Transcode(utf8.data(), utf8.length(), wide, errorOffset);
+    }
+
+    UtfResult Utf16ToUtf8(std::u16string_view utf16, std::string& utf8, size_t& errorOffset) {
+        return Transcode(utf16.data(), utf16.length(), utf8, errorOffset);
+    }
+
+    UtfResult Utf32ToUtf8(std::u32string_view utf32, std::string& utf8, size_t& errorOffset) {
+        return Transcode(utf32.data(), utf32.length(), utf8, errorOffset);
+    }
+
+    UtfResult WideToUtf8(std::wstring_view wide, std::string& utf8, size_t& errorOffset) {
+        return Transcode(wide.data(), wide.length(), utf8, errorOffset);
+    }
+
+    std::string Trim(const std::string& s, WhitespaceClass whitespace) {
+        return std::string(TrimView(s, whitespace));
+    }
+
+    std::pmr::string Trim(std::string_view s, std::pmr::memory_resource* resource) {
+        return std::pmr::string(TrimView(s), resource);
+    }
+
+    std::string_view TrimView(std::string_view s, WhitespaceClass whitespace) {
+        STRING_UTILS_PROBE(Trim, s.length());
+        const auto trimmed = TrimPiece(s, whitespace);
+        STRING_UTILS_PROBE_OUTPUT(trimmed.length());
+        return trimmed;
+    }
+
+    void TrimInPlace(std::string& s, WhitespaceClass whitespace) {
+        STRING_UTILS_PROBE(Trim, s.length());
+        const auto begin = SkipLeadingWhitespace(s, whitespace);
+        s.erase(SkipTrailingWhitespace(s, begin, whitespace));
+        s.erase(0, begin);
+        STRING_UTILS_PROBE_OUTPUT(s.length());
     }
 
-    std::string Indent(std::string linesIn, size_t spaces) {
+    std::string Indent(std::string_view linesIn, size_t spaces, LineEnding lineEnding,
+                       bool indentFirstLine) {
+        STRING_UTILS_PROBE(Indent, linesIn.length());
         std::string linesOut;
-        while (!linesIn.empty())
-        {
-            std::string line;
-            auto delimiter = linesIn.find("\r\n");
-            if (delimiter == std::string::npos)
-            {
-                line = linesIn;
-                linesIn.clear();
-            } else
-            {
-                line = linesIn.substr(0, delimiter + 2);
-                linesIn = linesIn.substr(delimiter + 2);
-            }
-            if (!linesOut.empty())
-            { linesOut.append(spaces, ' '); }
-            linesOut += line;
-        }
+        IndentLines(linesIn, spaces, lineEnding, indentFirstLine, linesOut);
+        STRING_UTILS_PROBE_OUTPUT(linesOut.length());
+        return linesOut;
+    }
+
+    void AppendIndented(std::string& linesOut, std::string_view linesIn, size_t spaces,
+                        LineEnding lineEnding, bool indentFirstLine) {
+        STRING_UTILS_PROBE(Indent, linesIn.length());
+        [[maybe_unused]] const auto lengthBefore = linesOut.length();
+        IndentLines(linesIn, spaces, lineEnding, indentFirstLine, linesOut);
+        STRING_UTILS_PROBE_OUTPUT(linesOut.length() - lengthBefore);
+    }
+
+    std::pmr::string Indent(std::string_view linesIn, size_t spaces,
+                            std::pmr::memory_resource* resource, LineEnding lineEnding,
+                            bool indentFirstLine) {
+        STRING_UTILS_PROBE(Indent, linesIn.length());
+        std::pmr::string linesOut(resource);
+        IndentLines(linesIn, spaces, lineEnding, indentFirstLine, linesOut);
+        STRING_UTILS_PROBE_OUTPUT(linesOut.length());
         return linesOut;
     }
 
     std::string ParseComponent(const std::string& s, size_t begin, size_t end) {
+        return std::string(ParseComponentView(s, begin, end));
+    }
+
+    std::string_view ParseComponentView(std::string_view s, size_t begin, size_t end) {
+        end = std::min(end, s.length());
+        STRING_UTILS_PROBE(ParseComponent, (end > begin) ? (end - begin) : 0);
         bool inString = false;
         int level = 1;
         size_t j = begin;
@@ -94,281 +1998,1341 @@ namespace StringUtils
                 }
             } else
             {
-                if ((level == 1) && (s[j] == ','))
-                {
-                    break;
-                } else if (s[j] == '"')
+                if ((level == 1) && (s[j] == ','))
+                {
+                    break;
+                } else if (s[j] == '"')
+                {
+                    inString = true;
+                } else if ((s[j] == '[') || (s[j] == '{') || (s[j] == '(') || (s[j] == '<'))
+                {
+                    ++level;
+                } else if ((s[j] == ']') || (s[j] == '}') || (s[j] == ')') || (s[j] == '>'))
+                { --level; }
+            }
+            ++j;
+        }
+        STRING_UTILS_PROBE_OUTPUT(j - begin);
+        return s.substr(begin, j - begin);
+    }
+
+    std::vector<size_t> FindComponentEnds(std::string_view s) {
+        STRING_UTILS_PROBE(ParseComponent, s.length());
+        std::vector<size_t> ends;
+        size_t begin = 0;
+        int level = 1;
+        bool inString = false;
+        size_t escaped = std::string_view::npos;
+        const auto endComponent = [&](size_t end) {
+            ends.push_back(end);
+            begin = end + 1;
+            level = 1;
+            inString = false;
+            escaped = std::string_view::npos;
+        };
+        const auto& operations = Simd::GetBlockOperations();
+        Simd::ForEachBlock(
+            s, [&](const char* block) { return ComponentStructureMask(operations, block); },
+            [&](size_t blockBegin, uint64_t mask) {
+                for (; mask != 0; mask &= mask - 1)
+                {
+                    const auto position = blockBegin + Simd::LowestBit(mask);
+                    if (position < begin)
+                    { continue; }
+                    const auto c = s[position];
+                    if (inString)
+                    {
+                        if (position == escaped)
+                        {
+                            continue;
+                        } else if (c == '\\')
+                        {
+                            escaped = position + 1;
+                        } else if (c == '"')
+                        { inString = false; }
+                    } else if (c == ',')
+                    {
+                        if (level == 1)
+                        { endComponent(position); }
+                    } else if (c == '"')
+                    {
+                        inString = true;
+                    } else if ((c == '[') || (c == '{') || (c == '(') || (c == '<'))
+                    {
+                        ++level;
+                    } else if ((c == ']') || (c == '}') || (c == ')') || (c == '>'))
+                    {
+                        if (--level == 0)
+                        { endComponent(position + 1); }
+                    }
+                }
+            });
+        if (begin <= s.length())
+        { ends.push_back(s.length()); }
+        return ends;
+    }
+
+    std::vector<std::string_view> SplitComponents(std::string_view s) {
+        std::vector<std::string_view> components;
+        size_t begin = 0;
+        for (auto end : FindComponentEnds(s))
+        {
+            components.push_back(s.substr(begin, end - begin));
+            begin = end + 1;
+        }
+        return components;
+    }
+
+    StreamComponentSplitter::StreamComponentSplitter(TokenDelegate tokenDelegate) :
+        tokenDelegate(tokenDelegate) {}
+
+    void StreamComponentSplitter::Feed(std::string_view chunk) {
+        // Positions are counted from the beginning of the string rather
+        // than the chunk, so the scan picks up where the last chunk left off.
+        const auto chunkBegin = streamLength;
+        const auto endComponent = [&](size_t end) {
+            if (begin >= chunkBegin)
+            {
+                tokenDelegate(chunk.substr(begin - chunkBegin, end - begin));
+            } else
+            {
+                pending.append(chunk.substr(0, end - chunkBegin));
+                tokenDelegate(pending);
+                pending.clear();
+            }
+            begin = end + 1;
+            level = 1;
+            inString = false;
+            escaped = std::string_view::npos;
+        };
+        const auto& operations = Simd::GetBlockOperations();
+        Simd::ForEachBlock(
+            chunk, [&](const char* block) { return ComponentStructureMask(operations, block); },
+            [&](size_t blockBegin, uint64_t mask) {
+                for (; mask != 0; mask &= mask - 1)
+                {
+                    const auto offset = blockBegin + Simd::LowestBit(mask);
+                    const auto position = chunkBegin + offset;
+                    if (position < begin)
+                    { continue; }
+                    const auto c = chunk[offset];
+                    if (inString)
+                    {
+                        if (position == escaped)
+                        {
+                            continue;
+                        } else if (c == '\\')
+                        {
+                            escaped = position + 1;
+                        } else if (c == '"')
+                        { inString = false; }
+                    } else if (c == ',')
+                    {
+                        if (level == 1)
+                        { endComponent(position); }
+                    } else if (c == '"')
+                    {
+                        inString = true;
+                    } else if ((c == '[') || (c == '{') || (c == '(') || (c == '<'))
+                    {
+                        ++level;
+                    } else if ((c == ']') || (c == '}') || (c == ')') || (c == '>'))
+                    {
+                        if (--level == 0)
+                        { endComponent(position + 1); }
+                    }
+                }
+            });
+        streamLength += chunk.length();
+        if (begin < chunkBegin)
+        {
+            pending.append(chunk);
+        } else if (begin < streamLength)
+        { pending.assign(chunk.substr(begin - chunkBegin)); }
+    }
+
+    void StreamComponentSplitter::Finish() {
+        if (begin <= streamLength)
+        { tokenDelegate(pending); }
+        pending.clear();
+        streamLength = 0;
+        begin = 0;
+        level = 1;
+        inString = false;
+        escaped = std::string_view::npos;
+    }
+
+    size_t StreamComponentSplitter::GetPendingLength() const {
+        return pending.length();
+    }
+
+    EscapeSpec::EscapeSpec(char escapeCharacter, const std::set<char>& charactersToEscape)
+        : escapeCharacter(escapeCharacter) {
+        for (auto c : charactersToEscape)
+        {
+            const auto index = (unsigned char)c;
+            members[index / 64] |= (uint64_t)1 << (index % 64);
+            characters += c;
+        }
+    }
+
+    EscapeSpec::EscapeSpec(char escapeCharacter, std::string_view charactersToEscape)
+        : escapeCharacter(escapeCharacter) {
+        for (auto c : charactersToEscape)
+        {
+            if (IsEscaped(c))
+            { continue; }
+            const auto index = (unsigned char)c;
+            members[index / 64] |= (uint64_t)1 << (index % 64);
+            characters += c;
+        }
+    }
+
+    std::string Escape(const std::string& s, char escapeCharacter,
+                       const std::set<char>& charactersToEscape) {
+        return Escape(std::string_view(s), EscapeSpec(escapeCharacter, charactersToEscape));
+    }
+
+    std::pmr::string Escape(std::string_view s, char escapeCharacter,
+                            const std::set<char>& charactersToEscape,
+                            std::pmr::memory_resource* resource) {
+        return Escape(s, EscapeSpec(escapeCharacter, charactersToEscape), resource);
+    }
+
+    std::string Escape(std::string_view s, const EscapeSpec& spec) {
+        STRING_UTILS_PROBE(Escape, s.length());
+        std::string output(EscapedLength(s, spec), '\0');
+        STRING_UTILS_PROBE_OUTPUT(output.length());
+        EscapeInto(s, spec, output.data());
+        return output;
+    }
+
+    std::pmr::string Escape(std::string_view s, const EscapeSpec& spec,
+                            std::pmr::memory_resource* resource) {
+        STRING_UTILS_PROBE(Escape, s.length());
+        std::pmr::string output(EscapedLength(s, spec), '\0', resource);
+        STRING_UTILS_PROBE_OUTPUT(output.length());
+        EscapeInto(s, spec, output.data());
+        return output;
+    }
+
+    std::string Unescape(const std::string& s, char escapeCharacter) {
+        STRING_UTILS_PROBE(Unescape, s.length());
+        std::string output(s.length(), '\0');
+        output.resize(UnescapeInto(s, escapeCharacter, output.data()));
+        STRING_UTILS_PROBE_OUTPUT(output.length());
+        return output;
+    }
+
+    std::pmr::string Unescape(std::string_view s, char escapeCharacter,
+                              std::pmr::memory_resource* resource) {
+        STRING_UTILS_PROBE(Unescape, s.length());
+        std::pmr::string output(s.length(), '\0', resource);
+        output.resize(UnescapeInto(s, escapeCharacter, output.data()));
+        STRING_UTILS_PROBE_OUTPUT(output.length());
+        return output;
+    }
+
+    void UnescapeInPlace(std::string& s, char escapeCharacter) {
+        STRING_UTILS_PROBE(Unescape, s.length());
+        s.resize(UnescapeInto(s, escapeCharacter, s.data()));
+        STRING_UTILS_PROBE_OUTPUT(s.length());
+    }
+
+    std::vector<std::string> Split(const std::string& s, char d) {
+        STRING_UTILS_PROBE(Split, s.length());
+        std::vector<std::string> values;
+        SplitByCharacter(s, d, [&values](std::string_view piece) { values.emplace_back(piece); });
+        STRING_UTILS_PROBE_OUTPUT(JoinedLength(values, {}));
+        return values;
+    }
+
+    std::vector<std::string> Split(const std::string& s, const std::string& d) {
+        STRING_UTILS_PROBE(Split, s.length());
+        const SplitRange pieces(s, d);
+        std::vector<std::string> values(pieces.begin(), pieces.end());
+        STRING_UTILS_PROBE_OUTPUT(JoinedLength(values, {}));
+        return values;
+    }
+
+    std::vector<std::string_view> SplitView(std::string_view s, char d) {
+        STRING_UTILS_PROBE(Split, s.length());
+        std::vector<std::string_view> values;
+        SplitByCharacter(s, d, [&values](std::string_view piece) { values.push_back(piece); });
+        STRING_UTILS_PROBE_OUTPUT(JoinedLength(values, {}));
+        return values;
+    }
+
+    std::vector<std::string_view> SplitView(std::string_view s, std::string_view d) {
+        STRING_UTILS_PROBE(Split, s.length());
+        const SplitRange pieces(s, d);
+        std::vector<std::string_view> values(pieces.begin(), pieces.end());
+        STRING_UTILS_PROBE_OUTPUT(JoinedLength(values, {}));
+        return values;
+    }
+
+    std::pmr::vector<std::pmr::string> Split(std::string_view s, char d,
+                                             std::pmr::memory_resource* resource) {
+        STRING_UTILS_PROBE(Split, s.length());
+        std::pmr::vector<std::pmr::string> values(resource);
+        SplitByCharacter(s, d, [&values](std::string_view piece) { values.emplace_back(piece); });
+        STRING_UTILS_PROBE_OUTPUT(JoinedLength(values, {}));
+        return values;
+    }
+
+    std::pmr::vector<std::pmr::string> Split(std::string_view s, std::string_view d,
+                                             std::pmr::memory_resource* resource) {
+        STRING_UTILS_PROBE(Split, s.length());
+        std::pmr::vector<std::pmr::string> values(resource);
+        for (auto piece : SplitRange(s, d))
+        { values.emplace_back(piece); }
+        STRING_UTILS_PROBE_OUTPUT(JoinedLength(values, {}));
+        return values;
+    }
+
+    SplitRange::Iterator::Iterator(std::string_view s, std::string_view delimiter,
+                                   char delimiterCharacter, bool delimiterIsCharacter) :
+        rest(TrimPiece(s)),
+        delimiter(delimiter),
+        delimiterCharacter(delimiterCharacter),
+        delimiterIsCharacter(delimiterIsCharacter),
+        done(false) {
+        Advance();
+    }
+
+    void SplitRange::Iterator::Advance() {
+        size_t position = 0;
+        while ((position < rest.length()) && IsTrimWhitespace(rest[position]))
+        { ++position; }
+        rest.remove_prefix(position);
+        if (rest.empty())
+        {
+            done = true;
+            return;
+        }
+        size_t delimiterPosition, delimiterLength;
+        if (delimiterIsCharacter)
+        {
+            delimiterPosition = rest.find(delimiterCharacter);
+            delimiterLength = 1;
+        } else
+        {
+            delimiterPosition = (delimiter.empty() ? std::string_view::npos : rest.find(delimiter));
+            delimiterLength = delimiter.length();
+        }
+        if (delimiterPosition == std::string_view::npos)
+        {
+            piece = rest;
+            rest.remove_prefix(rest.length());
+        } else
+        {
+            piece = TrimPiece(rest.substr(0, delimiterPosition));
+            rest.remove_prefix(delimiterPosition + delimiterLength);
+        }
+    }
+
+    auto SplitRange::Iterator::operator++() -> Iterator& {
+        Advance();
+        return *this;
+    }
+
+    auto SplitRange::Iterator::operator++(int) -> Iterator {
+        const auto previous = *this;
+        Advance();
+        return previous;
+    }
+
+    bool SplitRange::Iterator::operator==(const Iterator& other) const {
+        if (done || other.done)
+        { return (done == other.done); }
+        return ((piece.data() == other.piece.data()) && (rest.data() == other.rest.data()));
+    }
+
+    bool SplitRange::Iterator::operator!=(const Iterator& other) const {
+        return !(*this == other);
+    }
+
+    SplitRange::SplitRange(std::string_view s, char d) :
+        s(s),
+        delimiterCharacter(d),
+        delimiterIsCharacter(true) {}
+
+    SplitRange::SplitRange(std::string_view s, std::string_view d) : s(s), delimiter(d) {}
+
+    auto SplitRange::begin() const -> Iterator {
+        return Iterator(s, delimiter, delimiterCharacter, delimiterIsCharacter);
+    }
+
+    auto SplitRange::end() const -> Iterator {
+        return Iterator();
+    }
+
+    StreamSplitter::StreamSplitter(char d, TokenDelegate tokenDelegate) :
+        delimiter(1, d),
+        tokenDelegate(tokenDelegate) {}
+
+    StreamSplitter::StreamSplitter(std::string_view d, TokenDelegate tokenDelegate) :
+        delimiter(d),
+        tokenDelegate(tokenDelegate) {}
+
+    void StreamSplitter::Feed(std::string_view chunk) {
+        if (pendingDelimiter)
+        {
+            const auto content = SkipLeadingWhitespace(chunk, WhitespaceClass::Control);
+            if (content == chunk.length())
+            { return; }
+            const auto piece = std::string_view(pending);
+            tokenDelegate(TrimPiece(piece.substr(0, piece.length() - delimiter.length())));
+            pending.clear();
+            pendingDelimiter = false;
+            chunk.remove_prefix(content);
+        } else if (!pending.empty())
+        {
+            if (delimiter.empty())
+            {
+                pending.append(chunk);
+                return;
+            }
+
+            // The unfinished piece ends at the first delimiter, which may
+            // begin within the last few characters kept from earlier chunks.
+            const auto carried = std::min(pending.length(), delimiter.length() - 1);
+            const auto searchBegin = pending.length() - carried;
+            std::string straddle(pending, searchBegin);
+            straddle.append(chunk.substr(0, delimiter.length() - 1));
+            const auto straddleDelimiter = straddle.find(delimiter);
+            size_t afterDelimiter;
+            if (straddleDelimiter == std::string::npos)
+            {
+                const auto chunkDelimiter = chunk.find(delimiter);
+                if (chunkDelimiter == std::string_view::npos)
+                {
+                    pending.append(chunk);
+                    return;
+                }
+                pending.append(chunk.substr(0, chunkDelimiter));
+                afterDelimiter = chunkDelimiter + delimiter.length();
+            } else
+            {
+                pending.resize(searchBegin + straddleDelimiter);
+                afterDelimiter = straddleDelimiter + delimiter.length() - carried;
+            }
+            chunk.remove_prefix(afterDelimiter);
+            if (!EndPiece(pending, chunk))
+            { return; }
+            pending.clear();
+        }
+        Scan(chunk);
+    }
+
+    void StreamSplitter::Finish() {
+        if (!pending.empty())
+        { tokenDelegate(TrimPiece(pending)); }
+        pending.clear();
+        pendingDelimiter = false;
+    }
+
+    size_t StreamSplitter::GetPendingLength() const {
+        return pending.length();
+    }
+
+    void StreamSplitter::Scan(std::string_view rest) {
+        for (;;)
+        {
+            rest.remove_prefix(SkipLeadingWhitespace(rest, WhitespaceClass::Control));
+            if (rest.empty())
+            { return; }
+            const auto delimiterPosition = (delimiter.empty() ? std::string_view::npos
+                                                              : rest.find(delimiter));
+            if (delimiterPosition == std::string_view::npos)
+            {
+                pending.assign(rest.data(), rest.length());
+                return;
+            }
+            const auto afterDelimiter = delimiterPosition + delimiter.length();
+            if (!EndPiece(rest.substr(0, delimiterPosition), rest.substr(afterDelimiter)))
+            { return; }
+            rest.remove_prefix(afterDelimiter);
+        }
+    }
+
+    bool StreamSplitter::EndPiece(std::string_view piece, std::string_view after) {
+        // A delimiter made up only of whitespace gives the same piece
+        // whether it counts or not, so there's no need to wait.
+        if (
+            IsTrimWhitespace(delimiter.back())
+            && (SkipLeadingWhitespace(delimiter, WhitespaceClass::Control) < delimiter.length())
+            && (SkipLeadingWhitespace(after, WhitespaceClass::Control) == after.length())
+        )
+        {
+            // The piece may already be what's pending.
+            pending.assign(piece.data(), piece.length());
+            pending += delimiter;
+            pendingDelimiter = true;
+            return false;
+        }
+        tokenDelegate(TrimPiece(piece));
+        return true;
+    }
+
+    /**
+     * This contains the private properties of a PatternMatcher instance.
+     */
+    struct PatternMatcher::Impl
+    {
+        // Types
+
+        /**
+         * This is used to mark a state which is not the end
+         * of any pattern.
+         */
+        static constexpr size_t NoPattern = std::numeric_limits<size_t>::max();
+
+        // Properties
+
+        /**
+         * These are the patterns which the matcher finds.
+         */
+        std::vector<std::string> patterns;
+
+        /**
+         * This maps each character to its class.  Characters which
+         * appear in no pattern share class zero; every other
+         * character has a class of its own.
+         */
+        uint16_t characterClasses[256] = {0};
+
+        /**
+         * This is the number of different character classes.
+         */
+        size_t classCount = 1;
+
+        /**
+         * This is the automaton's transition table, holding, for each
+         * state and character class, the state which follows.
+         */
+        std::vector<uint32_t> transitions;
+
+        /**
+         * This holds, for each state, the number of characters
+         * matched to reach the state from the initial state.
+         */
+        std::vector<size_t> depths;
+
+        /**
+         * This holds, for each state, the index of the longest pattern
+         * which ends at the state, or NoPattern if none do.
+         */
+        std::vector<size_t> longestPatterns;
+
+        // Methods
+
+        /**
+         * This method adds a new state to the automaton.
+         *
+         * @param[in] depth
+         *      This is the number of characters matched to reach the state.
+         *
+         * @return
+         *      The index of the new state is returned.
+         */
+        uint32_t AddState(size_t depth) {
+            transitions.resize(transitions.size() + classCount, 0);
+            depths.push_back(depth);
+            longestPatterns.push_back(NoPattern);
+            return (uint32_t)depths.size() - 1;
+        }
+
+        /**
+         * This method builds the automaton for the patterns.
+         */
+        void Compile() {
+            for (const auto& pattern : patterns)
+            {
+                for (auto c : pattern)
+                {
+                    auto& characterClass = characterClasses[(uint8_t)c];
+                    if (characterClass == 0)
+                    { characterClass = (uint16_t)classCount++; }
+                }
+            }
+            (void)AddState(0);
+            for (size_t i = 0; i < patterns.size(); ++i)
+            {
+                const auto& pattern = patterns[i];
+                if (pattern.empty())
+                { continue; }
+                uint32_t state = 0;
+                for (auto c : pattern)
                 {
-                    inString = true;
-                } else if ((s[j] == '[') || (s[j] == '{') || (s[j] == '(') || (s[j] == '<'))
+                    const auto next = state * classCount + characterClasses[(uint8_t)c];
+                    if (transitions[next] == 0)
+                    {
+                        const auto child = AddState(depths[state] + 1);
+                        transitions[next] = child;
+                    }
+                    state = transitions[next];
+                }
+                if (longestPatterns[state] == NoPattern)
+                { longestPatterns[state] = i; }
+            }
+            std::vector<uint32_t> failures(depths.size(), 0);
+            std::vector<uint32_t> queue{0};
+            for (size_t i = 0; i < queue.size(); ++i)
+            {
+                const auto state = queue[i];
+                if (longestPatterns[state] == NoPattern)
+                { longestPatterns[state] = longestPatterns[failures[state]]; }
+                for (size_t characterClass = 0; characterClass < classCount; ++characterClass)
                 {
-                    ++level;
-                } else if ((s[j] == ']') || (s[j] == '}') || (s[j] == ')') || (s[j] == '>'))
-                { --level; }
+                    auto& next = transitions[state * classCount + characterClass];
+                    const auto fallback =
+                        ((state == 0)
+                             ? 0
+                             : transitions[failures[state] * classCount + characterClass]);
+                    if (next == 0)
+                    {
+                        next = fallback;
+                    } else
+                    {
+                        failures[next] = fallback;
+                        queue.push_back(next);
+                    }
+                }
             }
-            ++j;
         }
-        return s.substr(begin, j - begin);
+    };
+
+    PatternMatcher::~PatternMatcher() noexcept = default;
+    PatternMatcher::PatternMatcher(PatternMatcher&&) noexcept = default;
+    PatternMatcher& PatternMatcher::operator=(PatternMatcher&&) noexcept = default;
+
+    PatternMatcher::PatternMatcher(const std::vector<std::string>& patterns) :
+        impl_(new Impl()) {
+        impl_->patterns = patterns;
+        impl_->Compile();
     }
 
-    std::string Escape(const std::string& s, char escapeCharacter,
-                       const std::set<char>& charactersToEscape) {
-        std::string output;
-        for (size_t i = 0; i < s.length(); ++i)
-        {
-            if (charactersToEscape.find(s[i]) != charactersToEscape.end())
-            { output += escapeCharacter; }
-            output += s[i];
-        }
-        return output;
+    const std::vector<std::string>& PatternMatcher::GetPatterns() const {
+        return impl_->patterns;
     }
 
-    std::string Unescape(const std::string& s, char escapeCharacter) {
-        std::string output;
-        bool escape = false;
-        for (size_t i = 0; i < s.length(); i++)
+    bool PatternMatcher::FindNext(std::string_view s, size_t position, Match& match) const {
+        bool found = false;
+        uint32_t state = 0;
+        for (size_t i = position; i < s.length(); ++i)
         {
-            if ((escapeCharacter == s[i]) && (!escape))
+            state = impl_->transitions[state * impl_->classCount
+                                       + impl_->characterClasses[(uint8_t)s[i]]];
+            const auto end = i + 1;
+            if (found && (end - impl_->depths[state] > match.position))
+            { break; }
+            const auto pattern = impl_->longestPatterns[state];
+            if (pattern == Impl::NoPattern)
+            { continue; }
+            const auto length = impl_->patterns[pattern].length();
+            if (!found || (end - length < match.position)
+                || ((end - length == match.position) && (length > match.length)))
             {
-                escape = true;
-            } else
-            {
-                output += s[i];
-                escape = false;
+                found = true;
+                match.position = end - length;
+                match.length = length;
+                match.pattern = pattern;
             }
         }
-        return output;
+        return found;
     }
 
-    std::vector<std::string> Split(const std::string& s, char d) {
+    std::vector<std::string> SplitAny(const std::string& s, const PatternMatcher& delimiters) {
         std::vector<std::string> values;
-        auto remainder = Trim(s);
-        while (!remainder.empty())
+        const auto remainder = TrimPiece(s);
+        size_t position = 0;
+        PatternMatcher::Match delimiter;
+        while (position < remainder.length())
         {
-            auto delimiter = remainder.find_first_of(d);
-            if (delimiter == std::string::npos)
+            if (!delimiters.FindNext(remainder, position, delimiter))
             {
-                values.push_back(remainder);
-                remainder.clear();
-            } else
-            {
-                values.push_back(Trim(remainder.substr(0, delimiter)));
-                remainder = Trim(remainder.substr(delimiter + 1));
+                values.emplace_back(remainder.substr(position));
+                break;
             }
+            values.emplace_back(
+                TrimPiece(remainder.substr(position, delimiter.position - position)));
+            position = delimiter.position + delimiter.length;
+            while ((position < remainder.length()) && IsTrimWhitespace(remainder[position]))
+            { ++position; }
         }
         return values;
     }
 
-    std::vector<std::string> Split(const std::string& s, const std::string& d) {
-        std::vector<std::string> values;
-        auto remainder = Trim(s);
-        const auto delimiterLength = d.length();
-        while (!remainder.empty())
+    std::vector<std::string> SplitAny(const std::string& s,
+                                      const std::vector<std::string>& delimiters) {
+        return SplitAny(s, PatternMatcher(delimiters));
+    }
+
+    std::string ReplaceAll(const std::string& s, const PatternMatcher& patterns,
+                           const std::vector<std::string>& replacements) {
+        std::string output;
+        output.reserve(s.length());
+        size_t position = 0;
+        PatternMatcher::Match match;
+        while (patterns.FindNext(s, position, match))
         {
-            /* code */
-            auto delimiter = remainder.find(d);
-            if (delimiter == std::string::npos)
-            {
-                values.push_back(remainder);
-                remainder.clear();
-            } else
-            {
-                values.push_back(Trim(remainder.substr(0, delimiter)));
-                remainder = Trim(remainder.substr(delimiter + delimiterLength));
-            }
+            output.append(s, position, match.position - position);
+            if (match.pattern < replacements.size())
+            { output += replacements[match.pattern]; }
+            position = match.position + match.length;
         }
-        return values;
+        output.append(s, position, std::string::npos);
+        return output;
     }
 
-    std::string Join(const std::vector<std::string>& v, const char d) {
-        std::ostringstream output;
-        bool first = false;
-        for (const auto& piece : v)
+    std::string ReplaceAll(const std::string& s,
+                           const std::map<std::string, std::string>& replacements) {
+        std::vector<std::string> patterns, values;
+        patterns.reserve(replacements.size());
+        values.reserve(replacements.size());
+        for (const auto& replacement : replacements)
         {
-            if (!first)
-            {
-                first = true;
-            } else
-            { output << d; }
-            output << piece;
+            patterns.push_back(replacement.first);
+            values.push_back(replacement.second);
         }
-        return output.str();
+        return ReplaceAll(s, PatternMatcher(patterns), values);
+    }
+
+    std::string Join(const std::vector<std::string>& v, const char d) {
+        return JoinPieces(v, std::string_view(&d, 1));
     }
 
     std::string Join(const std::vector<std::string>& v, const std::string& d) {
-        std::ostringstream output;
-        bool first = false;
-        for (const auto& piece : v)
+        return JoinPieces(v, d);
+    }
+
+    std::pmr::string Join(const std::pmr::vector<std::pmr::string>& v, char d,
+                          std::pmr::memory_resource* resource) {
+        return JoinPieces(v, std::string_view(&d, 1), resource);
+    }
+
+    std::pmr::string Join(const std::pmr::vector<std::pmr::string>& v, std::string_view d,
+                          std::pmr::memory_resource* resource) {
+        return JoinPieces(v, d, resource);
+    }
+
+    std::vector<std::string> ParallelSplit(std::string_view s, char d, size_t threads) {
+        STRING_UTILS_PROBE(Split, s.length());
+        auto values = SplitInParallel<std::string>(s, d, ChooseThreadCount(s.length(), threads));
+        STRING_UTILS_PROBE_OUTPUT(JoinedLength(values, {}));
+        return values;
+    }
+
+    std::vector<std::string_view> ParallelSplitView(std::string_view s, char d,
+                                                    size_t threads) {
+        STRING_UTILS_PROBE(Split, s.length());
+        auto values = SplitInParallel<std::string_view>(s, d,
+                                                        ChooseThreadCount(s.length(), threads));
+        STRING_UTILS_PROBE_OUTPUT(JoinedLength(values, {}));
+        return values;
+    }
+
+    std::string ParallelJoin(const std::vector<std::string>& v, std::string_view d,
+                             size_t threads) {
+        const auto length = JoinedLength(v, d);
+        const auto workers = ChooseThreadCount(length, threads);
+        if (workers == 1)
+        { return JoinPieces(v, d); }
+        STRING_UTILS_PROBE(Join, length - d.length() * (v.size() - 1));
+        STRING_UTILS_PROBE_OUTPUT(length);
+
+        // Each worker copies a run of pieces making up about the same
+        // share of the joined string.  Where each run begins comes from
+        // adding up the lengths of the pieces before it.
+        std::vector<size_t> firstPieces(workers + 1, v.size());
+        std::vector<size_t> firstOffsets(workers + 1, length);
+        firstPieces[0] = firstOffsets[0] = 0;
+        size_t nextWorker = 1;
+        size_t pieceOffset = 0;
+        for (size_t i = 0; (i < v.size()) && (nextWorker < workers); ++i)
         {
-            if (!first)
+            while ((nextWorker < workers) && (pieceOffset >= length / workers * nextWorker))
             {
-                first = true;
-            } else
-            { output << d; }
-            output << piece;
+                firstPieces[nextWorker] = i;
+                firstOffsets[nextWorker] = pieceOffset;
+                ++nextWorker;
+            }
+            pieceOffset += v[i].length() + d.length();
         }
-        return output.str();
+        std::string joined(length, '\0');
+        const auto output = &joined[0];
+        RunInParallel(workers, [&](size_t worker) {
+            auto offset = firstOffsets[worker];
+            for (size_t i = firstPieces[worker]; i < firstPieces[worker + 1]; ++i)
+            {
+                const auto& piece = v[i];
+                (void)memcpy(output + offset, piece.data(), piece.length());
+                offset += piece.length();
+                if (i + 1 < v.size())
+                {
+                    (void)memcpy(output + offset, d.data(), d.length());
+                    offset += d.length();
+                }
+            }
+        });
+        return joined;
     }
 
     std::string Tolower(const std::string& s) {
-        std::ostringstream output;
-        for (char c : s)
-        { output << (char)tolower(c); }
-        return output.str();
+        std::string output(s.length(), '\0');
+        TolowerInto(s, &output[0]);
+        return output;
+    }
+
+    std::pmr::string Tolower(std::string_view s, std::pmr::memory_resource* resource) {
+        std::pmr::string output(s.length(), '\0', resource);
+        TolowerInto(s, &output[0]);
+        return output;
+    }
+
+    void TolowerInPlace(std::string& s) {
+        TolowerInto(s, &s[0]);
+    }
+
+    void TolowerInto(std::string_view s, char* output) {
+        STRING_UTILS_PROBE(Tolower, s.length());
+        STRING_UTILS_PROBE_OUTPUT(s.length());
+        Simd::ToLower(Simd::GetBlockOperations(), s.data(), output, s.length());
     }
 
     ToIntegerResult ToInteger(const std::string& stringNumber, intmax_t& number) {
-        size_t index = 0;
-        size_t state = 0;
-        bool negative = false;
-        intmax_t value = 0;
-        while (index < stringNumber.size())
-        {
-            switch (state)
+        return ToInteger<intmax_t>(stringNumber, number);
+    }
+
+    ToDoubleResult ToDouble(std::string_view numberString, double& number) {
+        return ParseReal(numberString, number);
+    }
+
+    ToDoubleResult ToFloat(std::string_view numberString, float& number) {
+        return ParseReal(numberString, number);
+    }
+
+    template <typename Number>
+    size_t ParseColumns(std::string_view buffer, char fieldDelimiter, char recordDelimiter,
+                        size_t columns, Number* values, size_t maxRecords,
+                        std::vector<FieldError>& errors, size_t& consumed) {
+        size_t records = 0;
+        size_t field = 0;
+        size_t fieldBegin = 0;
+        consumed = 0;
+        const auto finishField = [&](size_t fieldEnd) {
+            const auto text = TrimPiece(buffer.substr(fieldBegin, fieldEnd - fieldBegin));
+            FieldError error;
+            if (field < columns)
             {
-            case 0: {
-                if (stringNumber[index] == '-')
+                auto& value = values[records * columns + field];
+                if (!ParseField(text, value, error.kind))
                 {
-                    negative = true;
-                    ++index;
+                    value = 0;
+                    error.record = records;
+                    error.field = field;
+                    error.offset = (size_t)(text.data() - buffer.data());
+                    errors.push_back(error);
                 }
-                state = 1;
+            } else
+            {
+                error.record = records;
+                error.field = field;
+                error.offset = (size_t)(text.data() - buffer.data());
+                error.kind = FieldErrorKind::Unexpected;
+                errors.push_back(error);
             }
-            break;
-
-            case 1: {
-                if (stringNumber[index] == '0')
-                {
-                    state = 2;
-                } else if ((stringNumber[index] >= '1') && (stringNumber[index] <= '9'))
-                {
-                    state = 3;
-                    value = (decltype(value))(stringNumber[index] - '0');
-                    value = (value * (negative ? -1 : 1));
-                } else
-                { return ToIntegerResult::NotANumber; }
-                ++index;
+            ++field;
+            fieldBegin = fieldEnd + 1;
+        };
+        const auto finishRecord = [&](size_t recordEnd) {
+            if ((field == 0)
+                && TrimPiece(buffer.substr(fieldBegin, recordEnd - fieldBegin)).empty())
+            {
+                fieldBegin = recordEnd + 1;
+                return;
             }
-            break;
-
-            case 2: {
-                return ToIntegerResult::NotANumber;
+            finishField(recordEnd);
+            for (; field < columns; ++field)
+            {
+                values[records * columns + field] = 0;
+                FieldError error;
+                error.record = records;
+                error.field = field;
+                error.offset = recordEnd;
+                error.kind = FieldErrorKind::Missing;
+                errors.push_back(error);
             }
-            break;
-
-            case 3: {
-                if ((stringNumber[index] >= '0') && (stringNumber[index] <= '9'))
+            ++records;
+            field = 0;
+        };
+        if (maxRecords == 0)
+        { return 0; }
+        Simd::FindEither(
+            Simd::GetBlockOperations(), buffer, fieldDelimiter, recordDelimiter,
+            [&](size_t position) {
+                if (buffer[position] == recordDelimiter)
                 {
-                    const auto digit = (decltype(value))(stringNumber[index] - '0');
-                    if (negative)
-                    {
-                        if ((std::numeric_limits<decltype(value)>::lowest() + digit) / 10 > value)
-                        { return ToIntegerResult::Overflow; }
-                    } else
-                    {
-                        if ((std::numeric_limits<decltype(value)>::max() - digit) / 10 < value)
-                        { return ToIntegerResult::Overflow; }
-                    }
-                    value *= 10;
-                    if (negative)
-                    {
-                        value -= digit;
-                    } else
-                    { value += digit; }
-                    ++index;
+                    finishRecord(position);
+                    consumed = position + 1;
+                    return (records < maxRecords);
                 } else
-                { return ToIntegerResult::NotANumber; }
-            }
-            break;
-            }
-        }
-        if (state >= 2)
+                {
+                    finishField(position);
+                    return true;
+                }
+            });
+        if ((records < maxRecords) && (consumed < buffer.length()))
         {
-            number = value;
-            return ToIntegerResult::Success;
-        } else
+            finishRecord(buffer.length());
+            consumed = buffer.length();
+        }
+        return records;
+    }
+
+    template size_t ParseColumns<int64_t>(std::string_view, char, char, size_t, int64_t*, size_t,
+                                          std::vector<FieldError>&, size_t&);
+    template size_t ParseColumns<double>(std::string_view, char, char, size_t, double*, size_t,
+                                         std::vector<FieldError>&, size_t&);
+
+    template <typename Integer>
+    ToIntegerResult ToInteger(std::string_view numberString, Integer& number, int base) {
+        Integer value;
+        size_t consumed;
+        const auto result = ToIntegerPrefix(numberString, value, consumed, base);
+        if (result != ToIntegerResult::Success)
+        { return result; }
+        if (consumed != numberString.length())
         { return ToIntegerResult::NotANumber; }
+        number = value;
+        return ToIntegerResult::Success;
+    }
+
+    template <typename Integer>
+    ToIntegerResult ToIntegerPrefix(std::string_view numberString, Integer& number,
+                                    size_t& consumed, int base) {
+        static_assert(std::is_integral<Integer>::value && (sizeof(Integer) <= sizeof(uint64_t)),
+                      "ToInteger supports integer types of up to 64 bits");
+        STRING_UTILS_PROBE(ToInteger, numberString.length());
+        const auto positiveLimit = (uint64_t)std::numeric_limits<Integer>::max();
+        const auto negativeLimit = (std::is_signed<Integer>::value ? positiveLimit + 1 : 0);
+        bool negative;
+        uint64_t magnitude;
+        const auto result = ParseMagnitude(numberString, base, std::is_signed<Integer>::value,
+                                           positiveLimit, negativeLimit, negative, magnitude,
+                                           consumed);
+        if (result == ToIntegerResult::Success)
+        { number = (Integer)(negative ? (0 - magnitude) : magnitude); }
+        return result;
+    }
+
+#define STRING_UTILS_INSTANTIATE_TO_INTEGER(Integer)                                      \
+    template ToIntegerResult ToInteger<Integer>(std::string_view, Integer&, int);          \
+    template ToIntegerResult ToIntegerPrefix<Integer>(std::string_view, Integer&, size_t&, int);
+    STRING_UTILS_INSTANTIATE_TO_INTEGER(char)
+    STRING_UTILS_INSTANTIATE_TO_INTEGER(wchar_t)
+    STRING_UTILS_INSTANTIATE_TO_INTEGER(char16_t)
+    STRING_UTILS_INSTANTIATE_TO_INTEGER(char32_t)
+    STRING_UTILS_INSTANTIATE_TO_INTEGER(signed char)
+    STRING_UTILS_INSTANTIATE_TO_INTEGER(short)
+    STRING_UTILS_INSTANTIATE_TO_INTEGER(int)
+    STRING_UTILS_INSTANTIATE_TO_INTEGER(long)
+    STRING_UTILS_INSTANTIATE_TO_INTEGER(long long)
+    STRING_UTILS_INSTANTIATE_TO_INTEGER(unsigned char)
+    STRING_UTILS_INSTANTIATE_TO_INTEGER(unsigned short)
+    STRING_UTILS_INSTANTIATE_TO_INTEGER(unsigned int)
+    STRING_UTILS_INSTANTIATE_TO_INTEGER(unsigned long)
+    STRING_UTILS_INSTANTIATE_TO_INTEGER(unsigned long long)
+#undef STRING_UTILS_INSTANTIATE_TO_INTEGER
+
+    StringSink::StringSink(std::string& output) : output(output) {}
+
+    void StringSink::Write(std::string_view piece) {
+        output += piece;
+    }
+
+#if !defined(_WIN32)
+    static_assert((sizeof(IoVectorSink::IoVector) == sizeof(iovec))
+                      && (offsetof(IoVectorSink::IoVector, base) == offsetof(iovec, iov_base))
+                      && (offsetof(IoVectorSink::IoVector, length) == offsetof(iovec, iov_len)),
+                  "IoVectorSink::IoVector must have the same layout as iovec");
+#endif
+
+    auto IoVectorSink::GetPieces() const -> const std::vector<IoVector>& {
+        return pieces;
+    }
+
+    size_t IoVectorSink::GetLength() const {
+        return length;
+    }
+
+    void IoVectorSink::Clear() {
+        pieces.clear();
+        length = 0;
+    }
+
+    void IoVectorSink::Write(std::string_view piece) {
+        if (piece.empty())
+        { return; }
+        pieces.push_back({const_cast<char*>(piece.data()), piece.length()});
+        length += piece.length();
+    }
+
+    ChunkedSink::ChunkedSink(size_t capacity, ChunkDelegate chunkDelegate) :
+        buffer(std::max(capacity, (size_t)1)),
+        chunkDelegate(chunkDelegate) {}
+
+    void ChunkedSink::Flush() {
+        if (length > 0)
+        {
+            chunkDelegate(std::string_view(buffer.data(), length));
+            length = 0;
+        }
+    }
+
+    void ChunkedSink::Write(std::string_view piece) {
+        while (!piece.empty())
+        {
+            const auto amount = std::min(piece.length(), buffer.size() - length);
+            (void)memcpy(buffer.data() + length, piece.data(), amount);
+            length += amount;
+            piece.remove_prefix(amount);
+            if (length == buffer.size())
+            { Flush(); }
+        }
     }
 
     std::string InstantiateTemplate(const std::string& templateText,
                                     const std::map<std::string, std::string>& variables) {
-        std::ostringstream builder;
-        enum class State
-        {
-            Normal,
-            Escape,
-            TokenStart,
-            Token,
-        } state = State::Normal;
-        std::string token;
-        for (auto c : templateText)
+        STRING_UTILS_PROBE(InstantiateTemplate, templateText.length());
+        // Compiling the template would only pay off if it were used
+        // again, so a single use renders it as it's parsed.
+        std::string output;
+        output.reserve(templateText.length());
+        AppendInstantiatedTemplate(templateText, variables, output);
+        STRING_UTILS_PROBE_OUTPUT(output.length());
+        return output;
+    }
+
+    void InstantiateTemplate(const std::string& templateText,
+                             const std::map<std::string, std::string>& variables,
+                             TemplateSink& sink) {
+        STRING_UTILS_PROBE(InstantiateTemplate, templateText.length());
+        // The map can only be searched by std::string, so one key is
+        // reused for every lookup, to allocate only as names grow longer.
+        std::string key;
+        ParseTemplate(
+            templateText, [&sink](std::string_view text) { sink.Write(text); },
+            [&variables, &sink, &key](std::string_view name) {
+                key.assign(name.data(), name.length());
+                const auto variablesEntry = variables.find(key);
+                if (variablesEntry != variables.end())
+                { sink.Write(variablesEntry->second); }
+            });
+    }
+
+    std::pmr::string InstantiateTemplate(std::string_view templateText,
+                                         const std::map<std::string, std::string>& variables,
+                                         std::pmr::memory_resource* resource) {
+        STRING_UTILS_PROBE(InstantiateTemplate, templateText.length());
+        std::pmr::string output(resource);
+        AppendInstantiatedTemplate(templateText, variables, output);
+        STRING_UTILS_PROBE_OUTPUT(output.length());
+        return output;
+    }
+
+    /**
+     * This contains the private properties of a CompiledTemplate instance.
+     */
+    struct CompiledTemplate::Impl
+    {
+        // Types
+
+        /**
+         * This is a piece of the template, which is either literal
+         * text or a variable slot.
+         */
+        struct Segment
         {
-            switch (state)
+            /**
+             * For literal text, this is the position of the text
+             * in the literals string.
+             */
+            size_t offset;
+
+            /**
+             * For literal text, this is the number of characters of text.
+             */
+            size_t length;
+
+            /**
+             * For a variable slot, this is the slot index, or NoVariable
+             * if the segment is literal text.
+             */
+            size_t variable;
+        };
+
+        /**
+         * This is used to mark a segment which is literal text.
+         */
+        static constexpr size_t NoVariable = std::numeric_limits<size_t>::max();
+
+        // Properties
+
+        /**
+         * This holds all the literal text of the template,
+         * with escape characters removed.
+         */
+        std::string literals;
+
+        /**
+         * These are the pieces of the template, in order.
+         */
+        std::vector<Segment> segments;
+
+        /**
+         * These are the names of the variables in the template,
+         * in slot order.
+         */
+        std::vector<std::string> variableNames;
+
+        // Methods
+
+        /**
+         * This method appends the given literal text to the template.
+         *
+         * @param[in] text
+         *     This is the literal text to append.
+         */
+        void AppendLiteral(std::string_view text) {
+            if (segments.empty() || (segments.back().variable != NoVariable))
+            { segments.push_back({literals.length(), 0, NoVariable}); }
+            literals += text;
+            segments.back().length += text.length();
+        }
+
+        /**
+         * This method parses the given template text.
+         *
+         * @param[in] templateText
+         *     This is the template to parse.
+         */
+        void Parse(std::string_view templateText) {
+            std::map<std::string, size_t> variableIndexes;
+            ParseTemplate(
+                templateText, [this](std::string_view text) { AppendLiteral(text); },
+                [this, &variableIndexes](std::string_view name) {
+                    std::string token(name);
+                    const auto variableIndexesEntry =
+                        variableIndexes.emplace(token, variableNames.size());
+                    if (variableIndexesEntry.second)
+                    { variableNames.push_back(std::move(token)); }
+                    segments.push_back({0, 0, variableIndexesEntry.first->second});
+                });
+        }
+
+        /**
+         * This method produces an instance of the template, using the
+         * given function to obtain the value of each variable.
+         *
+         * @param[in] getValue
+         *     This is the function to call with a slot index to obtain
+         *     a pointer to the value of the corresponding variable,
+         *     or nullptr if the variable has no value.
+         *
+         * @return
+         *     The instantiated template is returned.
+         */
+        template <typename GetValue> std::string Render(GetValue getValue) const {
+            size_t length = literals.length();
+            for (const auto& segment : segments)
             {
-            case State::Normal: {
-                if (c == '\\')
-                {
-                    state = State::Escape;
-                } else if (c == '$')
+                if (segment.variable != NoVariable)
                 {
-                    state = State::TokenStart;
-                } else
-                { builder << c; }
-            }
-            break;
-
-            case State::Escape: {
-                state = State::Normal;
-                builder << c;
+                    const auto value = getValue(segment.variable);
+                    if (value != nullptr)
+                    { length += value->length(); }
+                }
             }
-            break;
-
-            case State::TokenStart: {
-                if (c == '{')
+            StringBuilder output;
+            output.Reserve(length);
+            for (const auto& segment : segments)
+            {
+                if (segment.variable == NoVariable)
                 {
-                    state = State::Token;
-                    token.clear();
+                    output.Append(
+                        std::string_view(literals).substr(segment.offset, segment.length));
                 } else
                 {
-                    state = State::Normal;
-                    builder << '$' << c;
+                    const auto value = getValue(segment.variable);
+                    if (value != nullptr)
+                    { output.Append(*value); }
                 }
             }
-            break;
+            return output.Finish();
+        }
 
-            case State::Token: {
-                if (c == '}')
+        /**
+         * This method writes an instance of the template to the given
+         * sink, using the given function to obtain the value of each
+         * variable.
+         *
+         * @param[in] getValue
+         *     This is the function to call with a slot index to obtain
+         *     a pointer to the value of the corresponding variable,
+         *     or nullptr if the variable has no value.
+         *
+         * @param[in,out] sink
+         *     This is where to write the instantiated template.
+         */
+        template <typename GetValue> void Render(GetValue getValue, TemplateSink& sink) const {
+            for (const auto& segment : segments)
+            {
+                if (segment.variable == NoVariable)
                 {
-                    const auto variablesEntry = variables.find(token);
-                    if (variablesEntry != variables.end())
-                    { builder << variablesEntry->second; }
-                    state = State::Normal;
+                    sink.Write(std::string_view(literals).substr(segment.offset, segment.length));
                 } else
-                { token += c; }
-            }
-            break;
-
-            default:
-                break;
+                {
+                    const auto value = getValue(segment.variable);
+                    if (value != nullptr)
+                    { sink.Write(*value); }
+                }
             }
         }
-        return builder.str();
+    };
+
+    CompiledTemplate::~CompiledTemplate() noexcept = default;
+    CompiledTemplate::CompiledTemplate(CompiledTemplate&&) noexcept = default;
+    CompiledTemplate& CompiledTemplate::operator=(CompiledTemplate&&) noexcept = default;
+
+    CompiledTemplate::CompiledTemplate(std::string_view templateText) : impl_(new Impl()) {
+        impl_->Parse(templateText);
+    }
+
+    const std::vector<std::string>& CompiledTemplate::GetVariableNames() const {
+        return impl_->variableNames;
+    }
+
+    std::string CompiledTemplate::Render(
+        const std::map<std::string, std::string>& variables) const {
+        return impl_->Render(VariableLookup(impl_->variableNames, variables));
+    }
+
+    void CompiledTemplate::Render(const std::map<std::string, std::string>& variables,
+                                  TemplateSink& sink) const {
+        impl_->Render(VariableLookup(impl_->variableNames, variables), sink);
+    }
+
+    std::string CompiledTemplate::Render(
+        const std::unordered_map<std::string, std::string>& variables) const {
+        return impl_->Render(VariableLookup(impl_->variableNames, variables));
+    }
+
+    void CompiledTemplate::Render(const std::unordered_map<std::string, std::string>& variables,
+                                  TemplateSink& sink) const {
+        impl_->Render(VariableLookup(impl_->variableNames, variables), sink);
+    }
+
+    std::string CompiledTemplate::Render(const std::vector<std::string_view>& values) const {
+        return impl_->Render(SlotLookup(values));
+    }
+
+    void CompiledTemplate::Render(const std::vector<std::string_view>& values,
+                                  TemplateSink& sink) const {
+        impl_->Render(SlotLookup(values), sink);
     }
 
     std::string NormalizeCaseInsensitiveString(const std::string& inputString) {
-        std::string outputString;
-        for (char c : inputString)
-        { outputString.push_back(tolower(c)); }
-        return outputString;
+        return Tolower(inputString);
     }
 
-    std::string StripMarginWhitespace(const std::string& inputString) {
-        std::string outputString;
-        for (char c : inputString) {
-            if (!std::isspace(c)) {
-                outputString += c;
-            }
+    int CaseInsensitiveCompare(std::string_view lhs, std::string_view rhs) {
+        const auto length = std::min(lhs.length(), rhs.length());
+        size_t i = 0;
+        while ((i + 8 <= length)
+               && (FoldAsciiCase(LoadWord(lhs.data() + i, 8))
+                   == FoldAsciiCase(LoadWord(rhs.data() + i, 8))))
+        { i += 8; }
+        for (; i < length; ++i)
+        {
+            const auto lhsCharacter = FoldAsciiCase(lhs[i]);
+            const auto rhsCharacter = FoldAsciiCase(rhs[i]);
+            if (lhsCharacter != rhsCharacter)
+            { return ((lhsCharacter < rhsCharacter) ? -1 : 1); }
+        }
+        if (lhs.length() == rhs.length())
+        { return 0; }
+        return ((lhs.length() < rhs.length()) ? -1 : 1);
+    }
+
+    size_t CaseInsensitiveHash::operator()(std::string_view s) const {
+        uint64_t hash = 0x9e3779b97f4a7c15 ^ s.length();
+        for (size_t i = 0; i < s.length(); i += 8)
+        {
+            const auto word = LoadWord(s.data() + i, std::min(s.length() - i, (size_t)8));
+            hash = (hash ^ FoldAsciiCase(word)) * 0xff51afd7ed558ccd;
+            hash ^= hash >> 32;
+        }
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53;
+        hash ^= hash >> 33;
+        return (size_t)hash;
+    }
+
+    bool CaseInsensitiveEqual::operator()(std::string_view lhs, std::string_view rhs) const {
+        if (lhs.length() != rhs.length())
+        { return false; }
+        for (size_t i = 0; i < lhs.length(); i += 8)
+        {
+            const auto length = std::min(lhs.length() - i, (size_t)8);
+            if (FoldAsciiCase(LoadWord(lhs.data() + i, length))
+                != FoldAsciiCase(LoadWord(rhs.data() + i, length)))
+            { return false; }
         }
+        return true;
+    }
+
+    bool CaseInsensitiveLess::operator()(std::string_view lhs, std::string_view rhs) const {
+        return (CaseInsensitiveCompare(lhs, rhs) < 0);
+    }
+
+    std::string StripMarginWhitespace(const std::string& inputString) {
+        std::string outputString(inputString.length(), '\0');
+        outputString.resize(StripMarginWhitespaceInto(inputString, &outputString[0]));
         return outputString;
     }
+
+    void StripMarginWhitespaceInPlace(std::string& s) {
+        s.resize(StripMarginWhitespaceInto(s, &s[0]));
+    }
+
+    size_t StripMarginWhitespaceInto(std::string_view s, char* output) {
+        STRING_UTILS_PROBE(StripMarginWhitespace, s.length());
+        const auto& operations = Simd::GetBlockOperations();
+        size_t written = 0;
+        size_t blockBegin = 0;
+        for (; blockBegin + Simd::BlockSize <= s.length(); blockBegin += Simd::BlockSize)
+        {
+            const auto block = s.data() + blockBegin;
+            const auto keep = ~WhitespaceMask(operations, WhitespaceClass::Space, block);
+            written += operations.compress(block, keep, output + written);
+        }
+        if (blockBegin < s.length())
+        {
+            // The last partial block is compressed into a separate buffer,
+            // since a whole block may be stored.
+            char tail[Simd::BlockSize] = {};
+            char compressed[Simd::BlockSize];
+            const auto tailLength = s.length() - blockBegin;
+            (void)memcpy(tail, s.data() + blockBegin, tailLength);
+            const auto keep = (~WhitespaceMask(operations, WhitespaceClass::Space, tail)
+                               & Simd::BitsBelow(tailLength));
+            const auto tailWritten = operations.compress(tail, keep, compressed);
+            (void)memcpy(output + written, compressed, tailWritten);
+            written += tailWritten;
+        }
+        STRING_UTILS_PROBE_OUTPUT(written);
+        return written;
+    }
 }  // namespace StringUtils
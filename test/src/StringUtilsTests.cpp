@@ -7,7 +7,11 @@
  */
 
 #include <gtest\gtest.h>
+#include <StringUtils\Instrumentation.hpp>
+#include <StringUtils\MappedFile.hpp>
 #include <StringUtils\StringUtils.hpp>
+#include <src\Simd.hpp>
+#include <algorithm>
 
 std::string vsprintfHelper(char const* format, ...) {
     va_list args;
@@ -30,15 +34,129 @@ TEST(StringUtilsTests, sprintfReturnsStringComparabletoCppString) {
     ASSERT_EQ(expectedOutput, StringUtils::sprintf("The answer is %d.", 47));
 }
 
+TEST(StringUtilsTests, sprintfLongerThanStackBuffer_Test) {
+    const std::string longText(1000, 'x');
+    EXPECT_EQ("<" + longText + ">", StringUtils::sprintf("<%s>", longText.c_str()));
+    EXPECT_EQ(longText + ", !!", vsprintfHelper("%s, %s!", longText.c_str(), "!"));
+}
+
+TEST(StringUtilsTests, Format_Test) {
+    EXPECT_EQ("The answer is 47.", StringUtils::Format("The answer is {}.", 47));
+    EXPECT_EQ("-9223372036854775808 18446744073709551615 0",
+              StringUtils::Format("{} {} {}", std::numeric_limits<int64_t>::lowest(),
+                                  std::numeric_limits<uint64_t>::max(), 0u));
+    EXPECT_EQ("0.1 0.1 1e+300 -2.5", StringUtils::Format("{} {} {} {}", 0.1, 0.1f, 1e300, -2.5));
+    const std::string who = "World";
+    EXPECT_EQ("Hello, World! x true {}",
+              StringUtils::Format("Hello, {}! {} {} {{}}", who, 'x', true));
+    EXPECT_EQ("1 {} {", StringUtils::Format("{} {} {", 1));
+    EXPECT_EQ("Hello, World: 3/3.5",
+              STRING_UTILS_FORMAT("Hello, {}: {}/{}", std::string_view(who), 3, 3.5));
+    EXPECT_EQ("no values", STRING_UTILS_FORMAT("no values"));
+    const char* missing = nullptr;
+    EXPECT_EQ("[(null)]", StringUtils::Format("[{}]", missing));
+    static_assert(StringUtils::CountFormatPlaceholders("{} {{}} {}") == 2, "");
+    static_assert(StringUtils::CountFormatPlaceholders("{x}") == std::string_view::npos, "");
+}
+
 TEST(StringUtilsTests, wcstombs_Test) {
     ASSERT_EQ("Hello, World!", StringUtils::wcstombs(L"Hello, World!"));
 }
 
+TEST(StringUtilsTests, ValidateUtf8_Test) {
+    struct TestVector
+    {
+        std::string input;
+        StringUtils::UtfResult expectedResult;
+        size_t expectedOffset;
+    };
+    const std::string ascii(100, 'a');
+    const std::vector<TestVector> testVectors{
+        {"", StringUtils::UtfResult::Success, 0},
+        {ascii + "caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80", StringUtils::UtfResult::Success,
+         114},
+        {ascii + "\x80", StringUtils::UtfResult::InvalidSequence, 100},
+        {"a\xc0\xaf" "b", StringUtils::UtfResult::InvalidSequence, 1},
+        {"a\xe0\x80\xaf" "b", StringUtils::UtfResult::InvalidSequence, 1},
+        {"a\xed\xa0\x80" "b", StringUtils::UtfResult::InvalidSequence, 1},
+        {"a\xf4\x90\x80\x80", StringUtils::UtfResult::InvalidSequence, 1},
+        {"a\xe2\x82", StringUtils::UtfResult::Truncated, 1},
+    };
+    for (const auto& testVector : testVectors)
+    {
+        size_t offset = 0;
+        EXPECT_EQ(testVector.expectedResult, StringUtils::ValidateUtf8(testVector.input, offset));
+        EXPECT_EQ(testVector.expectedOffset, offset);
+        EXPECT_EQ((testVector.expectedResult == StringUtils::UtfResult::Success),
+                  StringUtils::IsValidUtf8(testVector.input));
+    }
+}
+
+TEST(StringUtilsTests, Transcoding_Test) {
+    const std::string utf8 = std::string(70, 'x') + "caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80";
+    const std::u16string utf16 = std::u16string(70, u'x') + u"caf\u00e9 \u20ac \U0001f600";
+    const std::u32string utf32 = std::u32string(70, U'x') + U"caf\u00e9 \u20ac \U0001f600";
+    size_t offset = 0;
+    std::u16string utf16Out;
+    EXPECT_EQ(StringUtils::UtfResult::Success, StringUtils::Utf8ToUtf16(utf8, utf16Out, offset));
+    EXPECT_EQ(utf16, utf16Out);
+    std::u32string utf32Out;
+    EXPECT_EQ(StringUtils::UtfResult::Success, StringUtils::Utf8ToUtf32(utf8, utf32Out, offset));
+    EXPECT_EQ(utf32, utf32Out);
+    std::string utf8Out;
+    EXPECT_EQ(StringUtils::UtfResult::Success, StringUtils::Utf16ToUtf8(utf16, utf8Out, offset));
+    EXPECT_EQ(utf8, utf8Out);
+    EXPECT_EQ(StringUtils::UtfResult::Success, StringUtils::Utf32ToUtf8(utf32, utf8Out, offset));
+    EXPECT_EQ(utf8, utf8Out);
+    std::wstring wide;
+    EXPECT_EQ(StringUtils::UtfResult::Success, StringUtils::Utf8ToWide(utf8, wide, offset));
+    EXPECT_EQ(StringUtils::UtfResult::Success, StringUtils::WideToUtf8(wide, utf8Out, offset));
+    EXPECT_EQ(utf8, utf8Out);
+
+    utf8Out = "unchanged";
+    EXPECT_EQ(StringUtils::UtfResult::InvalidSequence,
+              StringUtils::Utf16ToUtf8(u"ab\xdc00" u"c", utf8Out, offset));
+    EXPECT_EQ((size_t)2, offset);
+    EXPECT_EQ("unchanged", utf8Out);
+    EXPECT_EQ(StringUtils::UtfResult::InvalidSequence,
+              StringUtils::Utf16ToUtf8(u"ab\xd800" u"c", utf8Out, offset));
+    EXPECT_EQ((size_t)2, offset);
+    EXPECT_EQ(StringUtils::UtfResult::Truncated,
+              StringUtils::Utf16ToUtf8(u"ab\xd800", utf8Out, offset));
+    EXPECT_EQ((size_t)2, offset);
+    EXPECT_EQ(StringUtils::UtfResult::InvalidSequence,
+              StringUtils::Utf32ToUtf8(U"a\x110000", utf8Out, offset));
+    EXPECT_EQ((size_t)1, offset);
+}
+
 TEST(StringUtilsTests, Trim_Test) {
     ASSERT_EQ("Hello, World!",
               StringUtils::Trim("  \t  \t\t  Hello, World! \r  \n \r\n \t \t\t  "));
 }
 
+TEST(StringUtilsTests, TrimView_Test) {
+    const std::string line = "  \t  \t\t  Hello, World! \r  \n \r\n \t \t\t  ";
+    const auto trimmed = StringUtils::TrimView(line);
+    ASSERT_EQ("Hello, World!", trimmed);
+    ASSERT_EQ(line.data() + 9, trimmed.data());
+    ASSERT_EQ("", StringUtils::TrimView(" \t\r\n "));
+    ASSERT_EQ("", StringUtils::TrimView(""));
+}
+
+TEST(StringUtilsTests, TrimInPlace_Test) {
+    const std::string record = std::string(100, ' ') + "value" + std::string(150, ' ');
+    EXPECT_EQ("value", StringUtils::TrimView(record));
+    auto line = record;
+    StringUtils::TrimInPlace(line);
+    EXPECT_EQ("value", line);
+    line = "\x01 Hello\x01 ";
+    StringUtils::TrimInPlace(line, StringUtils::WhitespaceClass::Space);
+    EXPECT_EQ("\x01 Hello\x01", line);
+    EXPECT_EQ("Hello", StringUtils::Trim("\x01 Hello\x01 "));
+    EXPECT_EQ("\x01 Hello\x01",
+              StringUtils::Trim("\x01 Hello\x01 ", StringUtils::WhitespaceClass::Space));
+}
+
 TEST(StringUtilsTests, Indent_Test) {
     ASSERT_EQ(
         "Hello, World!\r\n"
@@ -60,11 +178,43 @@ TEST(StringUtilsTests, Indent_Test) {
                   "\r\n}");
 }
 
+TEST(StringUtilsTests, IndentLineEndings_Test) {
+    const std::string mixed = "a\nb\r\nc\rd\n";
+    EXPECT_EQ("a\nb\r\n  c\rd\n", StringUtils::Indent(mixed, 2));
+    EXPECT_EQ("a\n  b\r\n  c\rd\n",
+              StringUtils::Indent(mixed, 2, StringUtils::LineEnding::Lf));
+    EXPECT_EQ("  a\n  b\r\n  c\r  d\n",
+              StringUtils::Indent(mixed, 2, StringUtils::LineEnding::Any, true));
+    EXPECT_EQ("", StringUtils::Indent("", 2, StringUtils::LineEnding::Lf, true));
+    std::string document = "{\n";
+    StringUtils::AppendIndented(document, "x;\ny;\n", 4, StringUtils::LineEnding::Lf, true);
+    document += "}\n";
+    EXPECT_EQ("{\n    x;\n    y;\n}\n", document);
+}
+
 TEST(StringUtilsTests, ParseComponent_Test) {
     const std::string line = "Value = {abc {c} = def} NextValue = 42";
     ASSERT_EQ("abc {c} = def}", StringUtils::ParseComponent(line, 9, line.length()));
 }
 
+TEST(StringUtilsTests, ParseComponentView_Test) {
+    const std::string line = "Value = {abc {c} = def} NextValue = 42";
+    const auto component = StringUtils::ParseComponentView(line, 9, line.length());
+    ASSERT_EQ("abc {c} = def}", component);
+    ASSERT_EQ(line.data() + 9, component.data());
+    ASSERT_EQ("a", StringUtils::ParseComponentView("a,b", 0, 100));
+}
+
+TEST(StringUtilsTests, SplitComponents_Test) {
+    const std::string line = R"(1,"a,\"b",[2,{3,4}],(x<y>),"",)";
+    EXPECT_EQ((std::vector<size_t>{1, 9, 19, 26, 29, 30}), StringUtils::FindComponentEnds(line));
+    EXPECT_EQ((std::vector<std::string_view>{"1", R"("a,\"b")", "[2,{3,4}]", "(x<y>)", R"("")",
+                                             ""}),
+              StringUtils::SplitComponents(line));
+    EXPECT_EQ((std::vector<std::string_view>{"a]", "c"}), StringUtils::SplitComponents("a]bc"));
+    EXPECT_EQ((std::vector<std::string_view>{""}), StringUtils::SplitComponents(""));
+}
+
 TEST(StringUtilsTests, Escape_Test) {
     const std::string line = "Hello, W^orld!";
     ASSERT_EQ("Hello,^ W^^orld^!", StringUtils::Escape(line, '^', {' ', '!', '^'}));
@@ -75,6 +225,32 @@ TEST(StringUtilsTests, Unescape_Test) {
     ASSERT_EQ("Hello, W^orld!", StringUtils::Unescape(line, '^'));
 }
 
+TEST(StringUtilsTests, EscapeSpec_Test) {
+    const StringUtils::EscapeSpec spec('^', " !^!");
+    EXPECT_EQ((size_t)3, spec.GetCharacters().length());
+    EXPECT_TRUE(spec.IsEscaped('!'));
+    EXPECT_FALSE(spec.IsEscaped('W'));
+    EXPECT_EQ("Hello,^ W^^orld^!", StringUtils::Escape("Hello, W^orld!", spec));
+    std::string longLine(200, 'x');
+    longLine[63] = longLine[64] = longLine[199] = '!';
+    auto expected = longLine;
+    expected.insert(199, 1, '^');
+    expected.insert(64, 1, '^');
+    expected.insert(63, 1, '^');
+    EXPECT_EQ(expected, StringUtils::Escape(longLine, spec));
+    const StringUtils::EscapeSpec wideSpec('\\', "abcdefghij\\");
+    EXPECT_EQ("\\a\\b-\\\\-\\j", StringUtils::Escape("ab-\\-j", wideSpec));
+}
+
+TEST(StringUtilsTests, UnescapeInPlace_Test) {
+    std::string line = "Hello,^ W^^orld^!";
+    StringUtils::UnescapeInPlace(line, '^');
+    EXPECT_EQ("Hello, W^orld!", line);
+    line = std::string(100, '^') + "^";
+    StringUtils::UnescapeInPlace(line, '^');
+    EXPECT_EQ(std::string(50, '^'), line);
+}
+
 TEST(StringUtilsTests, SplitWithCharDelimiter_Test) {
     const std::string line = "Hello, World!";
     ASSERT_EQ((std::vector<std::string>{"Hello,", "World!"}), StringUtils::Split(line, ' '));
@@ -86,6 +262,132 @@ TEST(StringUtilsTests, SplitWhithMultiCharDelimiter_Test) {
               StringUtils::Split(line, "::"));
 }
 
+TEST(StringUtilsTests, SplitEdgeCases_Test) {
+    ASSERT_EQ((std::vector<std::string>{}), StringUtils::Split("", ','));
+    ASSERT_EQ((std::vector<std::string>{}), StringUtils::Split(" \t ", ','));
+    ASSERT_EQ((std::vector<std::string>{"a", "", "b"}), StringUtils::Split(" a , , b ", ','));
+    ASSERT_EQ((std::vector<std::string>{"a", ""}), StringUtils::Split("a,,", ','));
+    ASSERT_EQ((std::vector<std::string>{"a"}), StringUtils::Split("a, ", ','));
+    ASSERT_EQ((std::vector<std::string>{"a", "b"}), StringUtils::Split("a\n\n\nb\n", '\n'));
+    ASSERT_EQ((std::vector<std::string>{"ab"}), StringUtils::Split("ab ", "b "));
+    ASSERT_EQ((std::vector<std::string>{"a", ";b"}), StringUtils::Split("a ;  ;b", " ;"));
+    ASSERT_EQ((std::vector<std::string>{"a b"}), StringUtils::Split(" a b ", ""));
+}
+
+TEST(StringUtilsTests, SplitView_Test) {
+    const std::string line = "Hello::World!:: My:Darling ";
+    const auto pieces = StringUtils::SplitView(line, "::");
+    ASSERT_EQ((std::vector<std::string_view>{"Hello", "World!", "My:Darling"}), pieces);
+    ASSERT_EQ(line.data() + 16, pieces[2].data());
+    ASSERT_EQ((std::vector<std::string_view>{"Hello,", "World!"}),
+              StringUtils::SplitView("Hello, World!", ' '));
+}
+
+TEST(StringUtilsTests, SplitRange_Test) {
+    const std::string line = " Hello, World! , My, Darling,, ";
+    std::vector<std::string_view> pieces;
+    for (auto piece : StringUtils::SplitRange(line, ','))
+    { pieces.push_back(piece); }
+    ASSERT_EQ((std::vector<std::string_view>{"Hello", "World!", "My", "Darling", ""}), pieces);
+    ASSERT_EQ(StringUtils::SplitView(line, ','), pieces);
+
+    const StringUtils::SplitRange range(line, ", ");
+    const auto found = std::find(range.begin(), range.end(), "My");
+    ASSERT_NE(range.end(), found);
+    ASSERT_EQ(line.data() + 17, found->data());
+    ASSERT_EQ(2, std::distance(range.begin(), found));
+    ASSERT_EQ(range.end(), std::find(range.begin(), range.end(), "Nowhere"));
+
+    auto first = range.begin();
+    const auto second = std::next(first);
+    ASSERT_EQ("Hello", *first++);
+    ASSERT_EQ(second, first);
+    const std::string_view kept = *first;
+    ++first;
+    ASSERT_EQ("World!", kept);
+    static_assert(
+        std::is_same<std::iterator_traits<StringUtils::SplitRange::Iterator>::iterator_category,
+                     std::input_iterator_tag>::value,
+        "pieces returned by value make SplitRange an input range"
+    );
+    ASSERT_EQ(StringUtils::SplitRange("", ',').begin(), StringUtils::SplitRange::Iterator());
+}
+
+TEST(StringUtilsTests, SplitWithCharDelimiterEveryInstructionSet_Test) {
+    const char alphabet[] = "ab ,\t\n\r\xe9, x  y";
+    std::string line;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        line += alphabet[(i * 7 + i / 13) % (sizeof(alphabet) - 1)];
+        if (i % 97 == 0)
+        { line.append(70, ' '); }
+    }
+    for (auto d : {',', ' ', '\n', '\xe9', 'q'})
+    {
+        const StringUtils::SplitRange range(line, d);
+        const std::vector<std::string_view> expected(range.begin(), range.end());
+        for (auto level : {StringUtils::Simd::Level::Scalar, StringUtils::Simd::Level::Sse2,
+                           StringUtils::Simd::Level::Avx2, StringUtils::Simd::Level::Avx512})
+        {
+            if (!StringUtils::Simd::IsSupported(level))
+            { continue; }
+            std::vector<std::string_view> pieces;
+            StringUtils::Simd::SplitByCharacter(
+                StringUtils::Simd::GetBlockOperations(level), line, d,
+                [&pieces](std::string_view piece) { pieces.push_back(piece); });
+            EXPECT_EQ(expected, pieces) << "level " << (int)level << ", delimiter " << (int)d;
+        }
+        EXPECT_EQ(expected, StringUtils::SplitView(line, d));
+    }
+}
+
+TEST(StringUtilsTests, PatternMatcher_Test) {
+    const StringUtils::PatternMatcher matcher({"he", "she", "hers", "his", ""});
+    StringUtils::PatternMatcher::Match match;
+    ASSERT_TRUE(matcher.FindNext("ushers", 0, match));
+    EXPECT_EQ((size_t)1, match.position);
+    EXPECT_EQ((size_t)3, match.length);
+    EXPECT_EQ((size_t)1, match.pattern);
+    ASSERT_TRUE(matcher.FindNext("ushers", 2, match));
+    EXPECT_EQ((size_t)2, match.position);
+    EXPECT_EQ((size_t)4, match.length);
+    EXPECT_EQ((size_t)2, match.pattern);
+    ASSERT_FALSE(matcher.FindNext("ushers", 3, match));
+    ASSERT_FALSE(matcher.FindNext("", 0, match));
+}
+
+TEST(StringUtilsTests, SplitAny_Test) {
+    const std::string line = " a\r\nb;c || d;\r\n;e|f ";
+    ASSERT_EQ((std::vector<std::string>{"a", "b", "c", "d", "", "e|f"}),
+              StringUtils::SplitAny(line, {"\r\n", ";", "||"}));
+    const StringUtils::PatternMatcher delimiters({"::", ":::"});
+    ASSERT_EQ((std::vector<std::string>{"Hello", "World!", "My", "Darling"}),
+              StringUtils::SplitAny("Hello::World!:::My::Darling", delimiters));
+    ASSERT_EQ(StringUtils::Split("x::y :: z::", "::"),
+              StringUtils::SplitAny("x::y :: z::", {"::"}));
+    ASSERT_EQ((std::vector<std::string>{}), StringUtils::SplitAny("  ", {","}));
+}
+
+TEST(StringUtilsTests, ReplaceAll_Test) {
+    const std::map<std::string, std::string> replacements{
+        {"brown", "red"},
+        {"fox", "wolf"},
+        {"cat", "dog"},
+    };
+    EXPECT_EQ("The quick red wolf jumps",
+              StringUtils::ReplaceAll("The quick brown fox jumps", replacements));
+    EXPECT_EQ("ba", StringUtils::ReplaceAll("ab", {{"a", "b"}, {"b", "a"}}));
+    EXPECT_EQ("<CRLF>x<CR>",
+              StringUtils::ReplaceAll("\r\nx\r", {{"\r", "<CR>"}, {"\r\n", "<CRLF>"}}));
+    const StringUtils::PatternMatcher patterns({"&", "<", ">"});
+    const std::vector<std::string> entities{"&amp;", "&lt;", "&gt;"};
+    EXPECT_EQ("&lt;a&gt; &amp;&amp; &lt;b&gt;",
+              StringUtils::ReplaceAll("<a> && <b>", patterns, entities));
+    EXPECT_EQ("", StringUtils::ReplaceAll("", patterns, entities));
+    EXPECT_EQ("&lt;a &amp;&amp; &lt;b",
+              StringUtils::ReplaceAll("<a> && <b>", patterns, {"&amp;", "&lt;"}));
+}
+
 TEST(StringUtilsTests, JoinSingleCharacterDelimiter_Test) {
     const std::vector<std::string> elements{"Hello", "World!"};
     ASSERT_EQ("Hello-World!", StringUtils::Join(elements, '-'));
@@ -96,6 +398,30 @@ TEST(StringUtilsTests, JoinMultiCharacterDelimiter_Test) {
     ASSERT_EQ("Hello, World!", StringUtils::Join(elements, ", "));
 }
 
+TEST(StringUtilsTests, JoinEdgeCases_Test) {
+    EXPECT_EQ("", StringUtils::Join({}, ','));
+    EXPECT_EQ("", StringUtils::Join({}, ", "));
+    EXPECT_EQ("a", StringUtils::Join({"a"}, ", "));
+    EXPECT_EQ(",,", StringUtils::Join({"", "", ""}, ','));
+    EXPECT_EQ("a::b", StringUtils::Join({"a", "b"}, "::"));
+}
+
+TEST(StringUtilsTests, StringBuilder_Test) {
+    StringUtils::StringBuilder builder;
+    builder.Reserve(100);
+    builder.Append("Hello");
+    builder.Append(',');
+    builder.Append(3, ' ');
+    builder.Append(std::string("World!"));
+    EXPECT_EQ((size_t)15, builder.GetLength());
+    EXPECT_EQ("Hello,   World!", builder.GetView());
+    const auto data = builder.GetView().data();
+    const auto built = builder.Finish();
+    EXPECT_EQ("Hello,   World!", built);
+    EXPECT_EQ(data, built.data());
+    EXPECT_EQ((size_t)0, builder.GetLength());
+}
+
 TEST(StringUtilsTests, Tolowers_Test) {
     EXPECT_EQ("hello", StringUtils::Tolower("Hello"));
     EXPECT_EQ("hello", StringUtils::Tolower("hello"));
@@ -109,6 +435,41 @@ TEST(StringUtilsTests, Tolowers_Test) {
     EXPECT_EQ("foo1bar", StringUtils::Tolower("FOO1BAR"));
 }
 
+TEST(StringUtilsTests, TolowerEveryInstructionSet_Test) {
+    std::string mixed;
+    for (size_t i = 0; i < 300; ++i)
+    { mixed += (char)(i * 37 + i / 7); }
+    std::string expected;
+    for (auto c : mixed)
+    { expected += (char)tolower(c); }
+    for (auto level : {StringUtils::Simd::Level::Scalar, StringUtils::Simd::Level::Sse2,
+                       StringUtils::Simd::Level::Avx2, StringUtils::Simd::Level::Avx512})
+    {
+        if (!StringUtils::Simd::IsSupported(level))
+        { continue; }
+        for (size_t length = 0; length <= mixed.length(); length += 13)
+        {
+            std::string output(length, '?');
+            StringUtils::Simd::ToLower(StringUtils::Simd::GetBlockOperations(level), mixed.data(),
+                                       &output[0], length);
+            EXPECT_EQ(expected.substr(0, length), output) << "level " << (int)level;
+        }
+    }
+    EXPECT_EQ(expected, StringUtils::Tolower(mixed));
+}
+
+TEST(StringUtilsTests, TolowerInPlace_Test) {
+    std::string s = "Hello, WORLD! \xC9T\xC9";
+    StringUtils::TolowerInPlace(s);
+    EXPECT_EQ("hello, world! \xC9t\xC9", s);
+    char buffer[5];
+    StringUtils::TolowerInto("FoO1B", buffer);
+    EXPECT_EQ("foo1b", std::string(buffer, sizeof(buffer)));
+    std::string empty;
+    StringUtils::TolowerInPlace(empty);
+    EXPECT_EQ("", empty);
+}
+
 TEST(StringUtilsTests, ToInteger_Test) {
     struct TestVector
     {
@@ -171,6 +532,183 @@ TEST(StringUtilsTests, ToInteger_Test) {
     }
 }
 
+TEST(StringUtilsTests, ToIntegerTyped_Test) {
+    int32_t int32Value = 0;
+    EXPECT_EQ(StringUtils::ToIntegerResult::Success,
+              StringUtils::ToInteger(std::string_view("-2147483648"), int32Value));
+    EXPECT_EQ(std::numeric_limits<int32_t>::lowest(), int32Value);
+    EXPECT_EQ(StringUtils::ToIntegerResult::Overflow,
+              StringUtils::ToInteger(std::string_view("2147483648"), int32Value));
+    EXPECT_EQ(StringUtils::ToIntegerResult::NotANumber,
+              StringUtils::ToInteger(std::string_view("007"), int32Value));
+    EXPECT_EQ(StringUtils::ToIntegerResult::NotANumber,
+              StringUtils::ToInteger(std::string_view("12x"), int32Value));
+    uint64_t uint64Value = 0;
+    EXPECT_EQ(StringUtils::ToIntegerResult::Success,
+              StringUtils::ToInteger(std::string_view("18446744073709551615"), uint64Value));
+    EXPECT_EQ(std::numeric_limits<uint64_t>::max(), uint64Value);
+    EXPECT_EQ(StringUtils::ToIntegerResult::Overflow,
+              StringUtils::ToInteger(std::string_view("18446744073709551616"), uint64Value));
+    EXPECT_EQ(StringUtils::ToIntegerResult::NotANumber,
+              StringUtils::ToInteger(std::string_view("-1"), uint64Value));
+    EXPECT_EQ(StringUtils::ToIntegerResult::Success,
+              StringUtils::ToInteger(std::string_view("DeadBeef"), uint64Value, 16));
+    EXPECT_EQ(0xdeadbeef, uint64Value);
+    EXPECT_EQ(StringUtils::ToIntegerResult::Success,
+              StringUtils::ToInteger(std::string_view("755"), uint64Value, 8));
+    EXPECT_EQ((uint64_t)0755, uint64Value);
+    EXPECT_EQ(StringUtils::ToIntegerResult::NotANumber,
+              StringUtils::ToInteger(std::string_view("8"), uint64Value, 8));
+    uint8_t uint8Value = 0;
+    EXPECT_EQ(StringUtils::ToIntegerResult::Overflow,
+              StringUtils::ToInteger(std::string_view("256"), uint8Value));
+    size_t consumed = 0;
+    int64_t int64Value = 0;
+    EXPECT_EQ(StringUtils::ToIntegerResult::Success,
+              StringUtils::ToIntegerPrefix("1234567890123,rest", int64Value, consumed));
+    EXPECT_EQ(1234567890123, int64Value);
+    EXPECT_EQ((size_t)13, consumed);
+    EXPECT_EQ(StringUtils::ToIntegerResult::Overflow,
+              StringUtils::ToIntegerPrefix("99999999999999999999 ", int64Value, consumed));
+    EXPECT_EQ((size_t)20, consumed);
+    char charValue = 0;
+    EXPECT_EQ(StringUtils::ToIntegerResult::Success,
+              StringUtils::ToInteger(std::string_view("65"), charValue));
+    EXPECT_EQ('A', charValue);
+    char16_t char16Value = 0;
+    EXPECT_EQ(StringUtils::ToIntegerResult::Success,
+              StringUtils::ToInteger(std::string_view("fffd"), char16Value, 16));
+    EXPECT_EQ(u'\ufffd', char16Value);
+    EXPECT_EQ(StringUtils::ToIntegerResult::Overflow,
+              StringUtils::ToInteger(std::string_view("65536"), char16Value));
+    char32_t char32Value = 0;
+    EXPECT_EQ(StringUtils::ToIntegerResult::Success,
+              StringUtils::ToInteger(std::string_view("1F600"), char32Value, 16));
+    EXPECT_EQ(U'\U0001F600', char32Value);
+    wchar_t wideValue = 0;
+    EXPECT_EQ(StringUtils::ToIntegerResult::Success,
+              StringUtils::ToInteger(std::string_view("32"), wideValue));
+    EXPECT_EQ(L' ', wideValue);
+}
+
+TEST(StringUtilsTests, ToDouble_Test) {
+    struct TestVector
+    {
+        std::string input;
+        double output;
+        StringUtils::ToDoubleResult expectedResult;
+    };
+    const std::vector<TestVector> testVectors{
+        {"0", 0.0, StringUtils::ToDoubleResult::Success},
+        {"42", 42.0, StringUtils::ToDoubleResult::Success},
+        {"-3.25", -3.25, StringUtils::ToDoubleResult::Success},
+        {"0.1", 0.1, StringUtils::ToDoubleResult::Success},
+        {"1234.5678e-2", 12.345678, StringUtils::ToDoubleResult::Success},
+        {"6.02214076E23", 6.02214076e23, StringUtils::ToDoubleResult::Success},
+        {"2.2250738585072014e-308", 2.2250738585072014e-308, StringUtils::ToDoubleResult::Success},
+        {"9007199254740993", 9007199254740992.0, StringUtils::ToDoubleResult::Success},
+        {"0.30000000000000000000001", 0.3, StringUtils::ToDoubleResult::Success},
+        {"1e400", 0.0, StringUtils::ToDoubleResult::Overflow},
+        {"1e-400", 0.0, StringUtils::ToDoubleResult::Underflow},
+        {"0e400", 0.0, StringUtils::ToDoubleResult::Success},
+        {"007", 7.0, StringUtils::ToDoubleResult::Success},
+        {".5", 0.5, StringUtils::ToDoubleResult::Success},
+        {"1.", 1.0, StringUtils::ToDoubleResult::Success},
+        {"1e+2", 100.0, StringUtils::ToDoubleResult::Success},
+        {".", 0.0, StringUtils::ToDoubleResult::NotANumber},
+        {"", 0.0, StringUtils::ToDoubleResult::NotANumber},
+        {"-", 0.0, StringUtils::ToDoubleResult::NotANumber},
+        {"1.2.3", 0.0, StringUtils::ToDoubleResult::NotANumber},
+        {"1e", 0.0, StringUtils::ToDoubleResult::NotANumber},
+        {"+1", 0.0, StringUtils::ToDoubleResult::NotANumber},
+        {" 1", 0.0, StringUtils::ToDoubleResult::NotANumber},
+        {"nan", 0.0, StringUtils::ToDoubleResult::NotANumber},
+    };
+    for (const auto& testVector : testVectors)
+    {
+        double output;
+        EXPECT_EQ(testVector.expectedResult, StringUtils::ToDouble(testVector.input, output))
+            << testVector.input;
+        if (testVector.expectedResult == StringUtils::ToDoubleResult::Success)
+        { EXPECT_EQ(testVector.output, output) << testVector.input; }
+    }
+    float floatValue;
+    EXPECT_EQ(StringUtils::ToDoubleResult::Success, StringUtils::ToFloat("0.1", floatValue));
+    EXPECT_EQ(0.1f, floatValue);
+    EXPECT_EQ(StringUtils::ToDoubleResult::Overflow, StringUtils::ToFloat("1e39", floatValue));
+}
+
+TEST(StringUtilsTests, ParseColumns_Test) {
+    // Arrange
+    const std::string buffer = (
+        "1,2,3\r\n"
+        "  -4 , 5,6\n"
+        "\n"
+        "7,x,99999999999999999999\n"
+        "8,9\n"
+        "10,11,12,13\n"
+        "14,15,16"
+    );
+    std::vector<int64_t> values(6 * 3, -1);
+    std::vector<StringUtils::FieldError> errors;
+    size_t consumed = 0;
+
+    // Act
+    const auto records = StringUtils::ParseColumns(buffer, ',', '\n', 3, values.data(), 6,
+                                                   errors, consumed);
+
+    // Assert
+    EXPECT_EQ((size_t)6, records);
+    EXPECT_EQ(buffer.length(), consumed);
+    EXPECT_EQ((std::vector<int64_t>{1, 2, 3, -4, 5, 6, 7, 0, 0, 8, 9, 0, 10, 11, 12, 14, 15, 16}),
+              values);
+    ASSERT_EQ((size_t)4, errors.size());
+    EXPECT_EQ((size_t)2, errors[0].record);
+    EXPECT_EQ((size_t)1, errors[0].field);
+    EXPECT_EQ(buffer.find('x'), errors[0].offset);
+    EXPECT_EQ(StringUtils::FieldErrorKind::NotANumber, errors[0].kind);
+    EXPECT_EQ((size_t)2, errors[1].field);
+    EXPECT_EQ(StringUtils::FieldErrorKind::Overflow, errors[1].kind);
+    EXPECT_EQ((size_t)3, errors[2].record);
+    EXPECT_EQ((size_t)2, errors[2].field);
+    EXPECT_EQ(StringUtils::FieldErrorKind::Missing, errors[2].kind);
+    EXPECT_EQ((size_t)4, errors[3].record);
+    EXPECT_EQ((size_t)3, errors[3].field);
+    EXPECT_EQ(StringUtils::FieldErrorKind::Unexpected, errors[3].kind);
+}
+
+TEST(StringUtilsTests, ParseColumnsResume_Test) {
+    // Arrange
+    const std::string buffer = "1.5\t2.25\n3\t-4e2\n5\t6\n";
+    double values[2 * 2];
+    std::vector<StringUtils::FieldError> errors;
+    size_t consumed = 0;
+
+    // Act
+    const auto first = StringUtils::ParseColumns(buffer, '\t', '\n', 2, values, 2, errors,
+                                                 consumed);
+
+    // Assert
+    EXPECT_EQ((size_t)2, first);
+    EXPECT_EQ(buffer.rfind('5'), consumed);
+    EXPECT_EQ(1.5, values[0]);
+    EXPECT_EQ(2.25, values[1]);
+    EXPECT_EQ(3.0, values[2]);
+    EXPECT_EQ(-400.0, values[3]);
+    EXPECT_TRUE(errors.empty());
+
+    // Act
+    const auto rest = std::string_view(buffer).substr(consumed);
+    const auto second = StringUtils::ParseColumns(rest, '\t', '\n', 2, values, 2, errors,
+                                                  consumed);
+
+    // Assert
+    EXPECT_EQ((size_t)1, second);
+    EXPECT_EQ(rest.length(), consumed);
+    EXPECT_EQ(5.0, values[0]);
+    EXPECT_EQ(6.0, values[1]);
+}
+
 TEST(StringUtilsTests, InstantiateTemplate) {
     // Arrange
     const std::string templateText = R"(
@@ -198,6 +736,122 @@ TEST(StringUtilsTests, InstantiateTemplate) {
         instance);
 }
 
+TEST(StringUtilsTests, CompiledTemplate) {
+    // Arrange
+    const StringUtils::CompiledTemplate compiledTemplate(R"(
+        Hello, ${who}!
+        The $10,000 {which you owe ${who}}
+        is due to \${someone}
+        $\{when}.  ${something} This one ends ${early
+    )");
+    const std::string expectedInstance = R"(
+        Hello, World!
+        The $10,000 {which you owe World}
+        is due to ${someone}
+        $\{when}.   This one ends )";
+
+    // Act
+    const auto& variableNames = compiledTemplate.GetVariableNames();
+    const auto instanceFromMap = compiledTemplate.Render(std::map<std::string, std::string>{
+        {"who", "World"},
+        {"when", "tomorrow"},
+    });
+    const auto instanceFromUnorderedMap =
+        compiledTemplate.Render(std::unordered_map<std::string, std::string>{
+            {"who", "World"},
+            {"something", ""},
+        });
+    const auto instanceFromSlots = compiledTemplate.Render(std::vector<std::string_view>{"World"});
+
+    // Assert
+    EXPECT_EQ((std::vector<std::string>{"who", "something"}), variableNames);
+    EXPECT_EQ(expectedInstance, instanceFromMap);
+    EXPECT_EQ(expectedInstance, instanceFromUnorderedMap);
+    EXPECT_EQ(expectedInstance, instanceFromSlots);
+    EXPECT_EQ("a$$", StringUtils::CompiledTemplate("a$$").Render(std::vector<std::string_view>{}));
+    EXPECT_EQ("a", StringUtils::CompiledTemplate("a$").Render(std::vector<std::string_view>{}));
+    EXPECT_EQ("a", StringUtils::CompiledTemplate("a\\").Render(std::vector<std::string_view>{}));
+}
+
+TEST(StringUtilsTests, InstantiateTemplateIntoSinks) {
+    // Arrange
+    const std::string templateText = "Hello, ${who}! \\${who} is ${what}.";
+    const std::map<std::string, std::string> variables{
+        {"who", "World"},
+        {"what", "a very long value which spans several chunks"},
+    };
+    const auto expectedInstance = StringUtils::InstantiateTemplate(templateText, variables);
+    const StringUtils::CompiledTemplate compiledTemplate(templateText);
+    StringUtils::IoVectorSink ioVectorSink;
+    std::string chunks;
+    size_t longestChunk = 0;
+    StringUtils::ChunkedSink chunkedSink(8, [&chunks, &longestChunk](std::string_view chunk) {
+        chunks += chunk;
+        longestChunk = std::max(longestChunk, chunk.length());
+    });
+    std::string appended = ">";
+    StringUtils::StringSink stringSink(appended);
+
+    // Act
+    StringUtils::InstantiateTemplate(templateText, variables, ioVectorSink);
+    compiledTemplate.Render(variables, chunkedSink);
+    chunkedSink.Flush();
+    compiledTemplate.Render(std::vector<std::string_view>{"World", variables.at("what")},
+                            stringSink);
+
+    // Assert
+    std::string gathered;
+    for (const auto& piece : ioVectorSink.GetPieces())
+    { gathered.append((const char*)piece.base, piece.length); }
+    EXPECT_EQ(expectedInstance, gathered);
+    EXPECT_EQ(expectedInstance.length(), ioVectorSink.GetLength());
+    EXPECT_EQ(templateText.data(), ioVectorSink.GetPieces()[0].base);
+    EXPECT_EQ(variables.at("who").data(), ioVectorSink.GetPieces()[1].base);
+    EXPECT_EQ(expectedInstance, chunks);
+    EXPECT_EQ((size_t)8, longestChunk);
+    EXPECT_EQ(">" + expectedInstance, appended);
+}
+
+TEST(StringUtilsTests, MemoryResourceOverloads_Test) {
+    // Arrange
+    char buffer[4096];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer),
+                                              std::pmr::null_memory_resource());
+    const std::map<std::string, std::string> variables{{"who", "World"}};
+
+    // Act
+    const auto pieces = StringUtils::Split(" Hello, beautiful , World! ", ',', &arena);
+    const auto multiCharacterPieces = StringUtils::Split("a::b:: c", "::", &arena);
+    const auto joined = StringUtils::Join(pieces, '-', &arena);
+    const auto multiCharacterJoined = StringUtils::Join(multiCharacterPieces, ", ", &arena);
+    const auto trimmed = StringUtils::Trim("  \t Hello, World! \r\n", &arena);
+    const auto escaped = StringUtils::Escape("Hello, W^orld!", '^', {' ', '!', '^'}, &arena);
+    const auto unescaped = StringUtils::Unescape("Hello,^ W^^orld^!", '^', &arena);
+    const auto indented = StringUtils::Indent("Hello\r\nWorld\r\n", 2, &arena);
+    const auto lfIndented = StringUtils::Indent("Hello\nWorld", 2, &arena,
+                                                StringUtils::LineEnding::Lf, true);
+    const auto instance = StringUtils::InstantiateTemplate("Hello, ${who}!", variables, &arena);
+    const auto lowered = StringUtils::Tolower("HeLLo", &arena);
+
+    // Assert
+    EXPECT_EQ((std::pmr::vector<std::pmr::string>{"Hello", "beautiful", "World!"}), pieces);
+    EXPECT_EQ(&arena, pieces.get_allocator().resource());
+    EXPECT_EQ(&arena, pieces[0].get_allocator().resource());
+    EXPECT_EQ((std::pmr::vector<std::pmr::string>{"a", "b", "c"}), multiCharacterPieces);
+    EXPECT_EQ("Hello-beautiful-World!", joined);
+    EXPECT_EQ("a, b, c", multiCharacterJoined);
+    EXPECT_EQ("Hello, World!", trimmed);
+    EXPECT_EQ("Hello,^ W^^orld^!", escaped);
+    EXPECT_EQ("Hello, W^orld!", unescaped);
+    EXPECT_EQ("Hello\r\n  World\r\n", indented);
+    EXPECT_EQ("  Hello\n  World", lfIndented);
+    EXPECT_EQ("Hello, World!", instance);
+    EXPECT_EQ("hello", lowered);
+    for (const auto* allocated :
+         {&joined, &trimmed, &escaped, &unescaped, &indented, &lfIndented, &lowered})
+    { EXPECT_EQ(&arena, allocated->get_allocator().resource()); }
+}
+
 TEST(StringUtilsTests, NormalizeCaseInsensitiveStringTests) {
     ASSERT_EQ("example", StringUtils::NormalizeCaseInsensitiveString("example"));
     ASSERT_EQ("example", StringUtils::NormalizeCaseInsensitiveString("eXAMple"));
@@ -208,9 +862,220 @@ TEST(StringUtilsTests, NormalizeCaseInsensitiveStringTests) {
     ASSERT_EQ("example", StringUtils::NormalizeCaseInsensitiveString("ExamplE"));
 }
 
+TEST(StringUtilsTests, CaseInsensitiveFunctors_Test) {
+    const StringUtils::CaseInsensitiveHash hash;
+    const StringUtils::CaseInsensitiveEqual equal;
+    const StringUtils::CaseInsensitiveLess less;
+    const std::vector<std::pair<std::string, std::string>> equivalents{
+        {"", ""},
+        {"Content-Type", "content-type"},
+        {"X-FORWARDED-FOR-SOMETHING-LONGER", "x-forwarded-for-something-longer"},
+        {"@[`{\xC9", "@[`{\xC9"},
+    };
+    for (const auto& equivalent : equivalents)
+    {
+        EXPECT_TRUE(equal(equivalent.first, equivalent.second)) << equivalent.first;
+        EXPECT_EQ(hash(equivalent.first), hash(equivalent.second)) << equivalent.first;
+        EXPECT_EQ(0, StringUtils::CaseInsensitiveCompare(equivalent.first, equivalent.second));
+    }
+    EXPECT_FALSE(equal("@", "`"));
+    EXPECT_FALSE(equal("[", "{"));
+    EXPECT_FALSE(equal("\xC9", "\xE9"));
+    EXPECT_FALSE(equal("Content-Type", "Content-Typ"));
+    EXPECT_FALSE(equal("Content-Type-A", "Content-Type-B"));
+    EXPECT_NE(hash("Content-Type"), hash("Content-Length"));
+    EXPECT_TRUE(less("apple", "BANANA"));
+    EXPECT_FALSE(less("BANANA", "apple"));
+    EXPECT_TRUE(less("Content-Type", "CONTENT-TYPES"));
+    EXPECT_GT(StringUtils::CaseInsensitiveCompare("Z", "a"), 0);
+    EXPECT_LT(StringUtils::CaseInsensitiveCompare("Accept-Encoding-Long", "accept-encoding-m"), 0);
+
+    std::unordered_map<std::string, int, StringUtils::CaseInsensitiveHash,
+                       StringUtils::CaseInsensitiveEqual>
+        headers{{"Content-Type", 1}, {"Content-Length", 2}};
+    EXPECT_EQ(1, headers.at("content-type"));
+    EXPECT_EQ(2, headers.at("CONTENT-LENGTH"));
+    std::map<std::string, int, StringUtils::CaseInsensitiveLess> orderedHeaders{
+        {"Content-Type", 1}, {"Accept", 2}};
+    const auto orderedHeadersEntry = orderedHeaders.find(std::string_view("ACCEPT"));
+    ASSERT_NE(orderedHeaders.end(), orderedHeadersEntry);
+    EXPECT_EQ(2, orderedHeadersEntry->second);
+}
+
 TEST(StringUtilsTest, StripMarginWhitespaceTest) {
     ASSERT_EQ("example", StringUtils::StripMarginWhitespace("example "));
     ASSERT_EQ("example,example", StringUtils::StripMarginWhitespace("example ,example"));
     ASSERT_EQ("example", StringUtils::StripMarginWhitespace(" example "));
     ASSERT_EQ("example,example", StringUtils::StripMarginWhitespace(" example, example "));
+}
+
+TEST(StringUtilsTests, StripMarginWhitespaceInPlace_Test) {
+    std::string payload;
+    std::string expected;
+    for (size_t i = 0; i < 300; ++i)
+    {
+        payload += (char)('a' + i % 26);
+        expected += (char)('a' + i % 26);
+        payload.append(i % 7, " \t\r\n\v\f"[i % 6]);
+    }
+    EXPECT_EQ(expected, StringUtils::StripMarginWhitespace(payload));
+    std::vector<char> buffer(payload.length());
+    EXPECT_EQ(expected.length(), StringUtils::StripMarginWhitespaceInto(payload, buffer.data()));
+    EXPECT_EQ(expected, std::string(buffer.data(), expected.length()));
+    StringUtils::StripMarginWhitespaceInPlace(payload);
+    EXPECT_EQ(expected, payload);
+    const char block[StringUtils::Simd::BlockSize + 1] =
+        "The quick brown fox jumps over the lazy dog, again and again!!!";
+    const uint64_t keep = 0xf0f0f0f0f0f0f0f1;
+    std::string kept;
+    for (size_t i = 0; i < StringUtils::Simd::BlockSize; ++i)
+    {
+        if ((keep >> i) & 1)
+        { kept += block[i]; }
+    }
+    for (auto level : {StringUtils::Simd::Level::Scalar, StringUtils::Simd::Level::Sse2,
+                       StringUtils::Simd::Level::Avx2, StringUtils::Simd::Level::Avx512})
+    {
+        if (!StringUtils::Simd::IsSupported(level))
+        { continue; }
+        char output[StringUtils::Simd::BlockSize];
+        const auto written =
+            StringUtils::Simd::GetBlockOperations(level).compress(block, keep, output);
+        EXPECT_EQ(kept, std::string(output, written)) << "level " << (int)level;
+    }
+}
+
+TEST(StringUtilsTests, Instrumentation_Test) {
+    StringUtils::Instrumentation::Reset();
+    (void)StringUtils::Split("a, bc,d", ',');
+    (void)StringUtils::Split("a, bc,d", ", ");
+    (void)StringUtils::Tolower("Hello");
+    const auto statistics = StringUtils::Instrumentation::GetStatistics();
+    ASSERT_EQ((size_t)StringUtils::Instrumentation::Function::Count, statistics.size());
+    const auto& split = statistics[(size_t)StringUtils::Instrumentation::Function::Split];
+    const auto& join = statistics[(size_t)StringUtils::Instrumentation::Function::Join];
+    const auto& trim = statistics[(size_t)StringUtils::Instrumentation::Function::Trim];
+    EXPECT_EQ(StringUtils::Instrumentation::Function::Split, split.function);
+    EXPECT_EQ((uint64_t)0, join.calls);
+    EXPECT_EQ((uint64_t)0, trim.calls);
+    if (StringUtils::Instrumentation::Enabled)
+    {
+        EXPECT_EQ((uint64_t)2, split.calls);
+        EXPECT_EQ((uint64_t)14, split.inputBytes);
+        EXPECT_EQ((uint64_t)9, split.outputBytes);
+        uint64_t latencyCalls = 0;
+        for (auto count : split.latency)
+        { latencyCalls += count; }
+        EXPECT_EQ((uint64_t)2, latencyCalls);
+        const auto& tolower = statistics[(size_t)StringUtils::Instrumentation::Function::Tolower];
+        EXPECT_EQ((uint64_t)1, tolower.calls);
+        EXPECT_EQ((uint64_t)5, tolower.outputBytes);
+        (void)StringUtils::TrimView(" a ");
+        EXPECT_EQ((uint64_t)1, StringUtils::Instrumentation::GetStatistics()[
+            (size_t)StringUtils::Instrumentation::Function::Trim
+        ].calls);
+    } else
+    { EXPECT_EQ((uint64_t)0, split.calls); }
+    const auto dump = StringUtils::Instrumentation::Dump();
+    EXPECT_EQ((size_t)0, dump.find("{\"functions\":[{\"name\":\"Split\",\"calls\":"));
+    EXPECT_NE(std::string::npos, dump.find("\"name\":\"sprintf\""));
+    StringUtils::Instrumentation::Reset();
+    EXPECT_EQ((uint64_t)0, StringUtils::Instrumentation::GetStatistics()[0].calls);
+}
+
+TEST(StringUtilsTests, ParallelSplitJoin_Test) {
+    std::string s;
+    for (size_t i = 0; s.length() < 1024 * 1024; ++i)
+    {
+        s += ((i % 7 == 0) ? " , " : "abc,");
+        s += std::to_string(i);
+        if (i % 11 == 0)
+        { s += "  \t"; }
+    }
+    const auto pieces = StringUtils::Split(s, ',');
+    for (size_t threads : {1, 2, 3, 8})
+    {
+        EXPECT_EQ(pieces, StringUtils::ParallelSplit(s, ',', threads)) << threads << " threads";
+        const auto views = StringUtils::ParallelSplitView(s, ',', threads);
+        EXPECT_EQ(pieces, std::vector<std::string>(views.begin(), views.end()));
+        EXPECT_EQ(StringUtils::Join(pieces, ", "),
+                  StringUtils::ParallelJoin(pieces, ", ", threads));
+    }
+    EXPECT_EQ(std::vector<std::string>({"a", "", "b"}), StringUtils::ParallelSplit("a, ,b", ','));
+    EXPECT_EQ("", StringUtils::ParallelJoin({}, ","));
+}
+
+TEST(StringUtilsTests, SplitFile_Test) {
+    const std::string path = "SplitFileTest.txt";
+    std::string contents;
+    for (size_t i = 0; i < 10000; ++i)
+    { contents += " piece" + std::to_string(i) + " ,"; }
+    contents += "last";
+    const auto file = fopen(path.c_str(), "wb");
+    ASSERT_NE(nullptr, file);
+    ASSERT_EQ(contents.length(), fwrite(contents.data(), 1, contents.length(), file));
+    (void)fclose(file);
+    {
+        auto pieces = StringUtils::SplitFile(path, ',');
+        ASSERT_TRUE(pieces.IsOpen());
+        EXPECT_EQ(contents, pieces.GetFile().GetContents());
+        const auto moved = std::move(pieces);
+        EXPECT_EQ(StringUtils::Split(contents, ','),
+                  std::vector<std::string>(moved.begin(), moved.end()));
+    }
+    StringUtils::MappedFile mappedFile;
+    EXPECT_TRUE(mappedFile.Open(path));
+    mappedFile.Close();
+    EXPECT_FALSE(mappedFile.IsOpen());
+    EXPECT_TRUE(mappedFile.GetContents().empty());
+    (void)remove(path.c_str());
+    EXPECT_FALSE(mappedFile.Open(path));
+    const auto missing = StringUtils::SplitFile(path, ',');
+    EXPECT_FALSE(missing.IsOpen());
+    EXPECT_TRUE(missing.begin() == missing.end());
+}
+
+TEST(StringUtilsTests, StreamSplitter_Test) {
+    std::vector<std::string> pieces;
+    StringUtils::StreamSplitter splitter(
+        "\r\n", [&pieces](std::string_view piece) { pieces.emplace_back(piece); }
+    );
+    splitter.Feed("Hello\r");
+    EXPECT_TRUE(pieces.empty());
+    splitter.Feed("\n World \r\n\r");
+    EXPECT_EQ((std::vector<std::string>{"Hello", "World"}), pieces);
+    EXPECT_EQ((size_t)0, splitter.GetPendingLength());
+    splitter.Feed("\nlast");
+    splitter.Finish();
+    EXPECT_EQ((std::vector<std::string>{"Hello", "World", "last"}), pieces);
+
+    // A delimiter ending in whitespace only counts once something follows it.
+    pieces.clear();
+    StringUtils::StreamSplitter commaSpace(
+        ", ", [&pieces](std::string_view piece) { pieces.emplace_back(piece); }
+    );
+    commaSpace.Feed("a, b, ");
+    commaSpace.Feed(" ");
+    commaSpace.Finish();
+    EXPECT_EQ(StringUtils::Split("a, b,  ", ", "), pieces);
+}
+
+TEST(StringUtilsTests, StreamComponentSplitter_Test) {
+    const std::string line = R"(1,"a,\"b",[2,{3,4}],(x<y>),"",)";
+    std::vector<std::string> components;
+    StringUtils::StreamComponentSplitter splitter(
+        [&components](std::string_view component) { components.emplace_back(component); }
+    );
+    for (size_t i = 0; i < line.length(); i += 3)
+    { splitter.Feed(line.substr(i, 3)); }
+    splitter.Finish();
+    EXPECT_EQ(
+        (std::vector<std::string>{"1", R"("a,\"b")", "[2,{3,4}]", "(x<y>)", R"("")", ""}),
+        components
+    );
+    components.clear();
+    splitter.Feed("a]");
+    splitter.Feed("bc");
+    splitter.Finish();
+    EXPECT_EQ((std::vector<std::string>{"a]", "c"}), components);
 }
\ No newline at end of file